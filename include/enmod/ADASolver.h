@@ -5,20 +5,23 @@
 #include "Types.h"
 #include <vector>
 
+// Replanning agent driven by AnytimeDStar. Each tick gets a budget of
+// expanded states, so runs are reproducible. The agent sticks to its route
+// until it is blocked or a bounded path proves it more than initial_epsilon
+// times worse than optimal, and waits in place while it has no route.
 class ADASolver : public Solver {
 public:
-    ADASolver(const Grid& grid_ref);
+    ADASolver(const Grid& grid_ref, size_t tick_expansions = 20000);
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
 
 private:
-    std::vector<StepReport> history;
+    TrajectoryRecorder history;
     Cost total_cost;
     EvacuationMode current_mode;
-    double epsilon; // Inflation factor
-
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
+    double initial_epsilon; // Inflation factor of the first search
+    size_t tick_expansions; // Planning budget per tick, in expanded states
 };
 
 #endif // ENMOD_ADA_SOLVER_H
\ No newline at end of file
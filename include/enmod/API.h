@@ -7,7 +7,8 @@
 
 class API : public Solver {
 public:
-    API(const Grid& grid_ref);
+    // mode selects the cost ordering used for policy improvement.
+    API(const Grid& grid_ref, EvacuationMode mode = EvacuationMode::NORMAL);
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
@@ -15,8 +16,9 @@ public:
     const Policy& getPolicy() const;
 
 private:
-    Cost calculatePolicyCost() const;
+    EvacuationMode mode;
     Policy policy;
+    Cost final_cost;
 };
 
 #endif // ENMOD_API_H
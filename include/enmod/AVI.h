@@ -4,16 +4,32 @@
 #include "Solver.h"
 #include <vector>
 
+class CostKey;
+
 class AVI : public Solver {
 public:
-    AVI(const Grid& grid_ref);
+    // mode selects the cost ordering used by the sweeps.
+    AVI(const Grid& grid_ref, EvacuationMode mode = EvacuationMode::NORMAL);
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
-    const std::vector<std::vector<Cost>>& getCostMap() const;
+    const std::vector<Cost>& getCostMap() const;
+    // Full sweeps run, including the final one that changed nothing.
+    int getIterations() const { return iterations; }
+    // Cells improved by the last sweep; 0 once converged.
+    size_t getResidual() const { return residual; }
 
 private:
-    std::vector<std::vector<Cost>> cost_map;
+    // Red-black Gauss-Seidel sweeps over packed integer keys, with row blocks
+    // split across threads on large grids.
+    void iteratePacked(const CostKey& key);
+    template <typename Order>
+    void iterate();
+
+    EvacuationMode mode;
+    std::vector<Cost> cost_map;
+    int iterations = 0;
+    size_t residual = 0;
 };
 
 #endif // ENMOD_AVI_H
@@ -2,6 +2,8 @@
 #define ENMOD_ACTOR_CRITIC_SOLVER_H
 
 #include "RLSolver.h"
+#include <atomic>
+#include <vector>
 
 class ActorCriticSolver : public RLSolver {
 public:
@@ -10,12 +12,22 @@ public:
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
     
-    void update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) override;
-    Direction chooseAction(const Position& state) override;
+    void update(int s, Direction a, double r, int s_next, Direction a_next) override;
+    Direction sampleAction(int state, std::mt19937& rng) override;
+
+protected:
+    // Seeds the critic with the state values and makes the action with the
+    // best one-step lookahead the actor's favourite.
+    void seedValues(const std::vector<double>& state_values) override;
+    // The actor's table, then the critic's values.
+    ModelLayout modelLayout() const override;
+    void saveModel(ModelData& model) const override;
+    void restoreModel(const ModelData& model) override;
 
 private:
-    // The Critic's state-value table
-    std::map<Position, double> state_value_table;
+    // The Critic's state values, indexed by Grid::toIndex(); relaxed atomics
+    // like the actor's ValueTable.
+    std::vector<std::atomic<float>> state_value_table;
 };
 
 #endif // ENMOD_ACTOR_CRITIC_SOLVER_H
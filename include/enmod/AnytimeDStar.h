@@ -0,0 +1,102 @@
+#ifndef ENMOD_ANYTIME_DSTAR_H
+#define ENMOD_ANYTIME_DSTAR_H
+
+#include "Grid.h"
+#include "IndexedHeap.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Anytime Dynamic A* (AD*) over a live grid, searching backwards from a
+// virtual goal joined to every exit towards the agent.
+// Each plan() call repairs the states around cells in the grid's change log,
+// then runs inflated searches with epsilon lowered step by step towards 1,
+// reusing OPEN and the inconsistent states (INCONS) of the previous search
+// instead of starting over. It stops once its expansion budget is spent and
+// keeps the best path published so far; the next call resumes from the same
+// state. A search cut off by the budget replaces the path only if no bounded
+// path exists for the current start.
+// Costs are the active cost ordering's lexicographic order as a mixed-radix
+// scalar, exact while the radix product stays below 2^53. Each ordering keeps
+// its own search state, so switching between them catches the other state up
+// with the changes it missed instead of restarting.
+class AnytimeDStar {
+public:
+    explicit AnytimeDStar(const Grid& grid_ref, double initial_epsilon = 2.5, double epsilon_step = 0.5);
+
+    // Expands at most expansion_budget states, so a run is reproducible
+    // whatever the machine load.
+    void plan(const Position& start, EvacuationMode mode, size_t expansion_budget);
+
+    // start, ..., an exit; empty while no path has been found yet.
+    const std::vector<Position>& getPath() const { return path; }
+    // Suboptimality bound of getPath(); 0 when the path comes from an
+    // interrupted search and has no bound.
+    double getPathEpsilon() const { return path_epsilon; }
+    // Cost of following path from path[first] to its end under the ordering
+    // of the last plan() call; infinite if it enters an unwalkable cell or
+    // does not end at an exit.
+    double pathCost(const std::vector<Position>& path, size_t first) const;
+    // True once a completed search proved that no exit is reachable.
+    bool isUnreachable() const { return unreachable; }
+    size_t getExpansions() const { return expansions; }
+
+private:
+    using Key = std::pair<double, double>;
+
+    // Everything one cost ordering's search carries between calls.
+    struct SearchState {
+        bool initialized = false;
+        // Mixed-radix weight of each Cost field (0 smoke, 1 time, 2 distance).
+        double weight[3] = {0, 0, 0};
+        // Cheapest possible step, the heuristic's unit.
+        double min_step = 0;
+        double epsilon = 0;
+        // Start the values were last repaired for.
+        int start_idx = -1;
+        size_t changes_seen = 0;
+
+        // Per cell, indexed by Grid::toIndex().
+        std::vector<double> g;
+        std::vector<double> rhs;
+        // A cell is in CLOSED when its stamp equals closed_generation.
+        std::vector<std::uint32_t> closed;
+        std::uint32_t closed_generation = 0;
+        std::vector<char> in_incons;
+        std::vector<int> incons;
+        IndexedHeap<Key> open_set;
+    };
+
+    // Seeds the active state with the exits.
+    void reset();
+    // False if the change log had nothing new.
+    bool applyChanges();
+    void updateState(int idx);
+    // Moves INCONS into OPEN, recomputes every key and empties CLOSED.
+    void beginIteration();
+    // False if the expansion count reached expansion_limit first.
+    bool computeOrImprovePath(size_t expansion_limit);
+    void extractPath();
+
+    double stepCost(int idx) const;
+    double heuristic(int idx) const;
+    bool isOccupiable(int idx) const;
+    Key key(int idx) const;
+
+    const Grid& grid;
+    double initial_epsilon;
+    double epsilon_step;
+
+    // Indexed by costOrderMode(): NORMAL and ALERT.
+    SearchState states[2];
+    SearchState* search = nullptr;
+    EvacuationMode order = EvacuationMode::NORMAL;
+    Position start_pos = {-1, -1};
+
+    std::vector<Position> path;
+    double path_epsilon = 0;
+    bool unreachable = false;
+    size_t expansions = 0;
+};
+
+#endif // ENMOD_ANYTIME_DSTAR_H
@@ -6,16 +6,22 @@
 
 class BIDP : public Solver {
 public:
-    BIDP(const Grid& grid_ref);
+    // mode selects the cost ordering used by the search.
+    BIDP(const Grid& grid_ref, EvacuationMode mode = EvacuationMode::NORMAL);
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
     
     // Expose the cost map for dynamic solvers
-    const std::vector<std::vector<Cost>>& getCostMap() const;
+    // Indexed by Grid::toIndex(); padding cells stay at the default (unreachable) cost.
+    const std::vector<Cost>& getCostMap() const;
 
 private:
-    std::vector<std::vector<Cost>> cost_map;
+    template <typename Order>
+    void search();
+
+    EvacuationMode mode;
+    std::vector<Cost> cost_map;
 };
 
 #endif // ENMOD_BIDP_H
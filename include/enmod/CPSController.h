@@ -30,7 +30,7 @@ private:
     void computeShortestPath();
     Grid dynamic_grid; // Make grid a member to be accessible in all functions
 
-    std::vector<StepReport> history;
+    TrajectoryRecorder history;
     Cost total_cost;
     Position start_pos;
     Position goal_pos;
@@ -12,14 +12,52 @@
         int time = MAX_COST;
         int distance = MAX_COST;
     
-        inline static EvacuationMode current_mode = EvacuationMode::NORMAL;
-    
+        // Time-first order (see LexTimeFirst). Mode-dependent comparisons go
+        // through an ordering policy or costLess() instead.
         bool operator<(const Cost& other) const;
         bool operator>(const Cost& other) const;
         bool operator==(const Cost& other) const;
         Cost operator+(const Cost& other) const;
     };
     
+    // Cost orderings. Planners are templated on one of these and pick it once
+    // per run with withCostOrder(), so comparisons inside a search never look
+    // at the evacuation mode. `fields` lists 0 smoke, 1 time, 2 distance from
+    // most to least significant.
+    struct LexTimeFirst {
+        static constexpr int fields[3] = {1, 2, 0};
+        static bool less(const Cost& a, const Cost& b) {
+            if (a.time != b.time) return a.time < b.time;
+            if (a.distance != b.distance) return a.distance < b.distance;
+            return a.smoke < b.smoke;
+        }
+    };
+    
+    struct LexSmokeFirst {
+        static constexpr int fields[3] = {0, 1, 2};
+        static bool less(const Cost& a, const Cost& b) {
+            if (a.smoke != b.smoke) return a.smoke < b.smoke;
+            if (a.time != b.time) return a.time < b.time;
+            return a.distance < b.distance;
+        }
+    };
+    
+    // NORMAL evacuates along the fastest route; ALERT and PANIC avoid smoke first.
+    template <typename Fn>
+    decltype(auto) withCostOrder(EvacuationMode mode, Fn&& fn) {
+        if (mode == EvacuationMode::NORMAL) return fn(LexTimeFirst{});
+        return fn(LexSmokeFirst{});
+    }
+    
+    // ALERT and PANIC share LexSmokeFirst. Maps a mode to one representative per
+    // ordering, for code that caches results by ordering rather than by mode.
+    inline EvacuationMode costOrderMode(EvacuationMode mode) {
+        return mode == EvacuationMode::NORMAL ? EvacuationMode::NORMAL : EvacuationMode::ALERT;
+    }
+    
+    // One-off comparison in the ordering of the given mode.
+    bool costLess(EvacuationMode mode, const Cost& a, const Cost& b);
+    
     std::ostream& operator<<(std::ostream& os, const Cost& cost);
     
     #endif // ENMOD_COST_H
@@ -0,0 +1,70 @@
+#ifndef ENMOD_COST_FIELD_CACHE_H
+#define ENMOD_COST_FIELD_CACHE_H
+
+#include "Cost.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Identifies a cost-to-exit field: the grid state (Grid::getStateHash()) and
+// the cost ordering, given as costOrderMode() of the evacuation mode.
+struct CostFieldKey {
+    std::uint64_t state_hash;
+    EvacuationMode order;
+
+    bool operator==(const CostFieldKey& other) const {
+        return state_hash == other.state_hash && order == other.order;
+    }
+};
+
+// Content-addressed store of immutable cost-to-exit fields shared between
+// solvers. Solvers that replay the same events on the same scenario reach the
+// same grid states, so all but the first computation of a field become lookups.
+// Least recently used fields are evicted once the total cell count exceeds the
+// budget. Thread-safe.
+class CostFieldCache {
+public:
+    using Field = std::shared_ptr<const std::vector<Cost>>;
+
+    explicit CostFieldCache(size_t max_cells = size_t(1) << 22);
+
+    // Process-wide instance used by the planners.
+    static CostFieldCache& shared();
+
+    // Returns nullptr on a miss.
+    Field find(const CostFieldKey& key);
+    void insert(const CostFieldKey& key, Field field);
+    void clear();
+    // Evicts down to the new budget straight away.
+    void setMaxCells(size_t cells);
+
+    size_t size() const;
+    size_t getHits() const;
+    size_t getMisses() const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const CostFieldKey& key) const {
+            return static_cast<size_t>(key.state_hash ^ static_cast<std::uint64_t>(key.order));
+        }
+    };
+    using Entry = std::pair<CostFieldKey, Field>;
+
+    // Caller holds the mutex.
+    void evictOverBudget();
+
+    mutable std::mutex mutex;
+    size_t max_cells;
+    size_t cached_cells = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    // Most recently used at the front.
+    std::list<Entry> entries;
+    std::unordered_map<CostFieldKey, std::list<Entry>::iterator, KeyHash> index;
+};
+
+#endif // ENMOD_COST_FIELD_CACHE_H
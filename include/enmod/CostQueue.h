@@ -0,0 +1,75 @@
+#ifndef ENMOD_COST_QUEUE_H
+#define ENMOD_COST_QUEUE_H
+
+#include "Grid.h"
+#include "RadixHeap.h"
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Packs a Cost into one integer whose numeric order matches a lexicographic
+// field order (most to least significant; 0 smoke, 1 time, 2 distance).
+// Field widths come from the grid's path cost bound, so sums of packed costs
+// never carry between fields.
+class CostKey {
+public:
+    CostKey(const Grid& grid, const int (&fields)[3]);
+
+    bool fits() const { return fits_64; }
+    // Total width of the packed fields.
+    int bits() const { return used_bits; }
+    std::uint64_t pack(const Cost& cost) const;
+    Cost unpack(std::uint64_t key) const;
+
+private:
+    // Indexed by field: 0 smoke, 1 time, 2 distance.
+    int shift[3];
+    std::uint64_t mask[3];
+    int used_bits;
+    bool fits_64;
+};
+
+// Priority queue of (Cost, cell index) for Dijkstra-style planners, ordered
+// by the Order policy (LexTimeFirst or LexSmokeFirst).
+// Uses a RadixHeap on packed keys when they fit in 64 bits and falls back to
+// a binary heap otherwise.
+template <typename Order>
+class CostQueue {
+public:
+    explicit CostQueue(const Grid& grid) : key(grid, Order::fields), use_radix(key.fits()) {}
+
+    bool empty() const { return use_radix ? radix.empty() : binary.empty(); }
+
+    void push(const Cost& cost, int idx) {
+        if (use_radix) radix.push(key.pack(cost), idx);
+        else binary.push({cost, idx});
+    }
+
+    std::pair<Cost, int> pop() {
+        if (use_radix) {
+            auto [packed, idx] = radix.pop();
+            return {key.unpack(packed), idx};
+        }
+        std::pair<Cost, int> top = binary.top();
+        binary.pop();
+        return top;
+    }
+
+private:
+    // Min-heap comparator; equal costs pop in ascending cell index like the radix heap.
+    struct Greater {
+        bool operator()(const std::pair<Cost, int>& a, const std::pair<Cost, int>& b) const {
+            if (Order::less(b.first, a.first)) return true;
+            if (Order::less(a.first, b.first)) return false;
+            return a.second > b.second;
+        }
+    };
+
+    CostKey key;
+    bool use_radix;
+    RadixHeap<int> radix;
+    std::priority_queue<std::pair<Cost, int>, std::vector<std::pair<Cost, int>>, Greater> binary;
+};
+
+#endif // ENMOD_COST_QUEUE_H
@@ -3,6 +3,7 @@
 
 #include "DynamicSolver.h"
 #include "Types.h"
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <deque>
@@ -34,6 +35,11 @@ struct NeuralNetwork {
     NeuralNetwork(int input_size, int hidden_size, int output_size);
     std::vector<double> predict(const std::vector<double>& input);
     void train(const std::vector<double>& input, const std::vector<double>& target);
+    // Weights and biases layer by layer, for the model cache. importWeights()
+    // returns false if the count does not match this network's shape.
+    size_t weightCount() const;
+    std::vector<float> exportWeights() const;
+    bool importWeights(const std::vector<float>& flat);
 
 private:
     int input_size, hidden_size, output_size;
@@ -68,8 +74,13 @@ private:
     double epsilon_min = 0.01;
     double epsilon_decay = 0.995;
 
+    // Weights start from the model cache when an earlier run on the same
+    // grid stored them; otherwise they are stored after this run.
+    std::uint64_t model_key = 0;
+    bool loaded_from_cache = false;
+
     // --- Simulation members ---
-    std::vector<StepReport> history;
+    TrajectoryRecorder history;
     Cost total_cost;
     EvacuationMode current_mode;
 
@@ -77,7 +88,6 @@ private:
     std::vector<double> getStateRepresentation(const Grid& current_grid, const Position& pos);
     Direction chooseAction(const std::vector<double>& state_representation, const Grid& current_grid, const Position& pos);
     void replay(); // The training step
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
 };
 
 #endif // ENMOD_DQN_SOLVER_H
\ No newline at end of file
@@ -2,20 +2,16 @@
 #define ENMOD_DSTARLITE_SOLVER_H
 
 #include "DynamicSolver.h"
+#include "IndexedHeap.h"
 #include "Types.h"
 #include <vector>
-#include <map>
-#include <queue>
 #include <limits>
 
 // Define a pair for the priority key in D* Lite
 using Key = std::pair<double, double>;
 
-struct DStarNode {
-    double g = std::numeric_limits<double>::infinity();
-    double rhs = std::numeric_limits<double>::infinity();
-};
-
+// D* Lite planning backwards from all exits at once (a virtual goal joined
+// to every exit), repaired incrementally as events change the grid.
 class DStarLiteSolver : public Solver {
 public:
     DStarLiteSolver(const Grid& grid_ref);
@@ -26,19 +22,22 @@ public:
 private:
     void initialize();
     double heuristic(const Position& a, const Position& b);
-    Key calculateKey(const Position& p);
-    void updateVertex(const Position& p);
+    double stepCost(int idx) const;
+    Key calculateKey(int idx);
+    void updateVertex(int idx);
     void computeShortestPath();
     Grid dynamic_grid; // Make grid a member to be accessible in all functions
 
-    std::vector<StepReport> history;
+    TrajectoryRecorder history;
     Cost total_cost;
     Position start_pos;
-    Position goal_pos;
     Position last_pos = {-1, -1};
     double k_m = 0.0;
-    std::map<Position, DStarNode> maze;
-    std::priority_queue<std::pair<Key, Position>, std::vector<std::pair<Key, Position>>, std::greater<std::pair<Key, Position>>> open_set;
+    size_t changes_seen = 0;
+    // g and rhs per cell, indexed by Grid::toIndex().
+    std::vector<double> g;
+    std::vector<double> rhs;
+    IndexedHeap<Key> open_set;
 };
 
-#endif // ENMOD_DSTARLITE_SOLVER_H
\ No newline at end of file
+#endif // ENMOD_DSTARLITE_SOLVER_H
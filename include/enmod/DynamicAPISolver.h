@@ -12,11 +12,9 @@ public:
     void generateReport(std::ofstream& report_file) const override;
 
 private:
-    std::vector<StepReport> history;
+    TrajectoryRecorder history;
     Cost total_cost;
     EvacuationMode current_mode;
-
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
 };
 
 #endif // ENMOD_DYNAMIC_API_SOLVER_H
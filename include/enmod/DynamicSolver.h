@@ -3,15 +3,7 @@
     
     #include "Solver.h"
     #include "Types.h"
-    
-    struct StepReport {
-        int time_step;
-        Grid grid_state;
-        Position agent_pos;
-        std::string action;
-        Cost current_total_cost;
-        EvacuationMode mode;
-    };
+    #include "TrajectoryRecorder.h"
     
     #endif // ENMOD_DYNAMIC_SOLVER_H
     
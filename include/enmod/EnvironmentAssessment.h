@@ -1,7 +1,7 @@
 #ifndef ENMOD_ENVIRONMENT_ASSESSMENT_H
 #define ENMOD_ENVIRONMENT_ASSESSMENT_H
 
-#include "enmod/Grid.h" // Needs Grid to check cell types and events
+#include "enmod/Grid.h" // Needs Grid for its maintained threat map
 #include "enmod/Types.h" // Needs Position and EvacuationMode
 
 // Declare the global assessment function
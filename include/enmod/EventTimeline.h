@@ -0,0 +1,62 @@
+#ifndef ENMOD_EVENT_TIMELINE_H
+#define ENMOD_EVENT_TIMELINE_H
+
+#include "Types.h"
+#include "json.hpp"
+#include <cstdint>
+#include <vector>
+
+using json = nlohmann::json;
+
+enum class HazardType : std::uint8_t { FIRE, SMOKE, PATH_BLOCK, UNKNOWN };
+
+// Compact form of one "dynamic_events" entry.
+// level holds the fire radius (1-3) or the smoke intensity (1 light, 2 heavy).
+struct TimedEvent {
+    int time;
+    Position pos;
+    HazardType type;
+    std::uint8_t level;
+
+    static TimedEvent fromJson(const json& event_config);
+};
+
+// Range of events returned by EventTimeline::Cursor::due().
+struct EventRange {
+    const TimedEvent* first;
+    const TimedEvent* last;
+    const TimedEvent* begin() const { return first; }
+    const TimedEvent* end() const { return last; }
+    bool empty() const { return first == last; }
+};
+
+// The "dynamic_events" array compiled once into a time-sorted vector.
+// Events that share a time step keep their config order.
+class EventTimeline {
+public:
+    EventTimeline() = default;
+    explicit EventTimeline(const json& events);
+
+    // Walks the timeline forward one tick at a time, so each event is visited once per run.
+    class Cursor {
+    public:
+        explicit Cursor(const EventTimeline& timeline);
+        // Events scheduled for exactly tick t. Ticks are expected to increase;
+        // asking for an earlier tick rewinds with a binary search.
+        EventRange due(int t);
+
+    private:
+        const TimedEvent* first;
+        const TimedEvent* last;
+        const TimedEvent* next;
+    };
+
+    Cursor cursor() const { return Cursor(*this); }
+    const std::vector<TimedEvent>& getEvents() const { return events; }
+    bool empty() const { return events.empty(); }
+
+private:
+    std::vector<TimedEvent> events;
+};
+
+#endif // ENMOD_EVENT_TIMELINE_H
@@ -6,7 +6,8 @@
 
 class FIDP : public Solver {
 public:
-    FIDP(const Grid& grid_ref);
+    // mode selects the cost ordering used by the search.
+    FIDP(const Grid& grid_ref, EvacuationMode mode = EvacuationMode::NORMAL);
     
     void run() override;
     void run(const Position& start_pos); 
@@ -16,8 +17,13 @@ public:
     std::vector<Position> getEvacuationPath(const Position& start_pos) const;
 
 private:
-    std::vector<std::vector<Cost>> cost_map;
-    std::vector<std::vector<Position>> parent_map;
+    template <typename Order>
+    void search(const Position& start_pos);
+
+    EvacuationMode mode;
+    // Both maps are indexed by Grid::toIndex().
+    std::vector<Cost> cost_map;
+    std::vector<int> parent_map;
 };
 
 #endif // ENMOD_FIDP_H
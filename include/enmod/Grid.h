@@ -1,22 +1,33 @@
     #ifndef ENMOD_GRID_H
     #define ENMOD_GRID_H
-    
+
     #include "Cost.h"
-    #include "Types.h" 
+    #include "Types.h"
+    #include "EventTimeline.h"
+    #include "ThreatMap.h"
     #include "json.hpp"
+    #include <array>
+    #include <cstdint>
+    #include <memory>
     #include <vector>
     #include <string>
-    #include <map>
-    
+
     using json = nlohmann::json;
-    
+
     class Policy;
-    
+
     struct FireEvent {
         Position pos;
         std::string size;
         int radius;
     };
+
+    // Component-wise totals of the grid's move costs.
+    struct CostBound {
+        long long smoke = 0;
+        long long time = 0;
+        long long distance = 0;
+    };
     
     class Grid {
     public:
@@ -33,30 +44,89 @@
         Position getNextPosition(const Position& current, Direction dir) const;
         const json& getConfig() const;
         void addHazard(const json& event_config);
+        void applyEvent(const TimedEvent& event);
+        // Compiled once from "dynamic_events" and shared by every copy of this grid.
+        const EventTimeline& getEventTimeline() const { return *timeline; }
+        // Every in-bounds event applied to this grid, in order.
+        const std::vector<TimedEvent>& getAppliedEvents() const { return applied_events; }
+        // Cells whose move cost, walkability or type changed after construction,
+        // in order and possibly repeated. Incremental planners repair from a suffix of it.
+        const std::vector<int>& getChangedCells() const { return changed_cells; }
+        // Hash of everything a cost-to-exit field depends on: dimensions, exits,
+        // and each cell's walkability and move cost. Grids in the same state hash
+        // equal however they got there; kept up to date as hazards are applied.
+        std::uint64_t getStateHash() const { return state_hash; }
         CellType getCellType(const Position& pos) const;
         std::string getSmokeIntensity(const Position& pos) const;
-    
+
+        // --- Index-based access ---
+        // Cells live in one row-major array padded with a one-cell WALL border,
+        // so a neighbour index (idx + offset) is always in range and planners
+        // can skip the isValid() check in their inner loops.
+        int getStride() const { return stride; }
+        int getCellCount() const { return static_cast<int>(cells.size()); }
+        int toIndex(int r, int c) const { return (r + 1) * stride + (c + 1); }
+        int toIndex(const Position& pos) const { return toIndex(pos.row, pos.col); }
+        Position toPosition(int idx) const { return {idx / stride - 1, idx % stride - 1}; }
+        // Offsets in the same order as Direction: UP, DOWN, LEFT, RIGHT.
+        const std::array<int, 4>& getNeighborOffsets() const { return neighbor_offsets; }
+        bool isWalkableAt(int idx) const { return cells[idx] != CellType::WALL; }
+        bool isExitAt(int idx) const { return cells[idx] == CellType::EXIT; }
+        CellType getCellTypeAt(int idx) const { return cells[idx]; }
+        bool hasHeavySmokeAt(int idx) const { return (hazards[idx] & HAZARD_SMOKE_MASK) == HAZARD_SMOKE_HEAVY; }
+        // Precomputed in addHazard(); a single load instead of a scan over active fires.
+        const Cost& getMoveCostAt(int idx) const { return move_costs[idx]; }
+        // Evacuation mode an agent standing on the cell should adopt (see ThreatMap).
+        EvacuationMode getThreatLevelAt(int idx) const { return threat_map.getMode(idx); }
+        EvacuationMode getThreatLevel(const Position& pos) const;
+        // Sum of every interior cell's move cost, so no simple path can cost more.
+        // Planners use it to size packed integer priority keys.
+        const CostBound& getPathCostBound() const { return path_cost_bound; }
+
         std::string toHtmlString() const;
-        std::string toHtmlStringWithCost(const std::vector<std::vector<Cost>>& cost_map) const;
+        std::string toHtmlStringWithCost(const std::vector<Cost>& cost_map) const;
         std::string toHtmlStringWithPath(const std::vector<Position>& path) const;
         std::string toHtmlStringWithPolicy(const Policy& policy) const;
         std::string toHtmlStringWithAgent(const Position& agent_pos) const;
          void setCellUnwalkable(const Position& pos);
-    
+
     private:
+        // Packed per-cell hazard byte; the low two bits hold the smoke intensity.
+        static constexpr std::uint8_t HAZARD_SMOKE_NONE = 0;
+        static constexpr std::uint8_t HAZARD_SMOKE_LIGHT = 1;
+        static constexpr std::uint8_t HAZARD_SMOKE_HEAVY = 2;
+        static constexpr std::uint8_t HAZARD_SMOKE_MASK = 3;
+        // Set once a fire's radius covers the cell; the first covering fire fixes its cost.
+        static constexpr std::uint8_t HAZARD_FIRE_INFLUENCE = 4;
+
         std::string grid_name;
         int rows;
         int cols;
-        std::vector<std::vector<CellType>> grid_map;
+        int stride;
+        std::array<int, 4> neighbor_offsets;
+        std::vector<CellType> cells;
+        std::vector<std::uint8_t> hazards;
+        std::vector<Cost> move_costs;
+        CostBound path_cost_bound;
+        ThreatMap threat_map;
         Position start_pos;
         std::vector<Position> exit_pos;
-        json grid_config;
-        std::map<Position, std::string> smoke_intensities;
+        // Shared so that copying a Grid does not copy the config JSON.
+        std::shared_ptr<const json> grid_config;
+        std::shared_ptr<const EventTimeline> timeline;
+        std::vector<TimedEvent> applied_events;
+        std::vector<int> changed_cells;
+        std::uint64_t state_hash = 0;
         std::vector<FireEvent> active_fires;
-    
+
+        void setSmoke(int idx, std::uint8_t level);
+        void stampFire(const FireEvent& fire);
+        void refreshMoveCost(int idx);
+        void setMoveCost(int idx, const Cost& cost);
+        void rebuildFireThreats();
+        std::uint64_t cellStateHash(int idx) const;
         std::string cellToHtml(int r, int c, const std::string& content = "") const;
     };
-    
+
     #endif // ENMOD_GRID_H
-    
 
@@ -0,0 +1,37 @@
+#ifndef ENMOD_GRID_HEURISTICS_H
+#define ENMOD_GRID_HEURISTICS_H
+
+#include "Grid.h"
+#include <limits>
+#include <vector>
+
+// Obstacle-aware lower bound on the number of steps to the nearest exit (BFS
+// distance), shared by the A* family. Entering a walkable cell costs at least
+// one time unit, so a step count is also an admissible, consistent bound on
+// the time cost.
+// Walls and lost exits only lengthen paths, so a stale field stays admissible.
+// update() rebuilds it lazily, only once the grid's change log shows a new
+// wall or a lost exit, to keep the bound tight.
+class GridHeuristics {
+public:
+    static constexpr int UNREACHABLE = std::numeric_limits<int>::max();
+
+    explicit GridHeuristics(const Grid& grid_ref);
+
+    void update();
+    const Grid& getGrid() const { return grid; }
+
+    // Indexed by Grid::toIndex(); UNREACHABLE when no exit can be reached.
+    int exitDistance(int idx) const { return exit_distance[idx]; }
+    int exitDistance(const Position& pos) const { return exit_distance[grid.toIndex(pos)]; }
+
+private:
+    void rebuild();
+
+    const Grid& grid;
+    std::vector<int> exit_distance;
+    std::vector<int> frontier;
+    size_t changes_seen = 0;
+};
+
+#endif // ENMOD_GRID_HEURISTICS_H
@@ -0,0 +1,85 @@
+#ifndef ENMOD_HPA_GRAPH_H
+#define ENMOD_HPA_GRAPH_H
+
+#include "Grid.h"
+#include "GridHeuristics.h"
+#include "SearchWorkspace.h"
+#include <array>
+#include <utility>
+#include <vector>
+
+// Hierarchical path-finding (HPA*) over a live grid.
+// The grid is cut into square clusters. Each maximal walkable run along a
+// cluster border becomes an entrance: one transition in the middle of a short
+// run, two at the ends of a long one. Transition cells and exits are the
+// abstract nodes. Intra-cluster edges are cluster-bounded shortest paths
+// between a cluster's nodes, computed per cost ordering the first time a
+// search touches the cluster. Inter-cluster edges read the live move cost.
+// update() reads the grid's change log and only marks the clusters around
+// changed cells (and the borders they sit on) for recomputation.
+class HPAGraph {
+public:
+    explicit HPAGraph(const Grid& grid_ref, int cluster_size = 10);
+
+    void update();
+    const Grid& getGrid() const { return grid; }
+
+    // First refined leg of the abstract route from start to the nearest
+    // reachable exit: start, ..., the first abstract node on the route.
+    // Empty if no exit is reachable. A replanning agent takes one step and
+    // plans again, so later legs are never refined.
+    const std::vector<Position>& findFirstLeg(const Position& start, EvacuationMode mode);
+
+    int getClusterCount() const { return static_cast<int>(clusters.size()); }
+
+private:
+    struct Cluster {
+        int row0, col0, rows, cols;
+        // Abstract nodes (cell indices) and their links to cells in
+        // neighbouring clusters as (node slot, cell index).
+        std::vector<int> nodes;
+        std::vector<std::pair<int, int>> links;
+        bool nodes_valid = false;
+        // Row-major nodes x nodes matrix per ordering (see orderSlot()).
+        std::array<std::vector<Cost>, 2> intra;
+        std::array<bool, 2> intra_valid = {false, false};
+    };
+
+    int clusterOf(int r, int c) const { return (r / cluster_size) * cluster_cols + (c / cluster_size); }
+    int clusterOfCell(int idx) const;
+    void buildBorder(int cluster, bool horizontal);
+    void invalidateBorder(int cluster, bool horizontal);
+    void buildNodes(int cluster);
+
+    template <typename Order>
+    const std::vector<Position>& search(const Position& start);
+    template <typename Order>
+    void ensureIntra(int cluster);
+    // Dijkstra from source_cell bounded to the cluster; fills local_cost and local_parent.
+    template <typename Order>
+    void clusterSearch(int cluster, int source_cell);
+    const std::vector<Position>& localPath(int cluster, int target_cell);
+
+    const Grid& grid;
+    int cluster_size;
+    int cluster_rows;
+    int cluster_cols;
+    std::vector<Cluster> clusters;
+    // Transitions as (cell, cell) pairs on each cluster's bottom (horizontal)
+    // and right (vertical) border.
+    std::vector<std::vector<std::pair<int, int>>> border_down;
+    std::vector<std::vector<std::pair<int, int>>> border_right;
+    // Slot of each cell in its cluster's node list, -1 for non-nodes.
+    std::vector<int> node_slot;
+    size_t changes_seen = 0;
+
+    GridHeuristics heuristics;
+    SearchWorkspace workspace;
+    // Scratch for cluster-bounded searches, indexed by local cell.
+    std::vector<Cost> local_cost;
+    std::vector<int> local_parent;
+    std::vector<std::pair<Cost, int>> local_heap;
+    std::vector<Position> leg;
+};
+
+#endif // ENMOD_HPA_GRAPH_H
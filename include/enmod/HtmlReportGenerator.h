@@ -3,6 +3,7 @@
 
 #include "Grid.h"
 #include "Solver.h"
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,8 @@ struct Result {
     Cost cost;
     double weighted_cost;
     double execution_time; 
+    // Set for solvers that train a learner.
+    std::optional<TrainingStats> training;
 };
 
 class HtmlReportGenerator {
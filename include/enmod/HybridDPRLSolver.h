@@ -3,7 +3,7 @@
 
 #include "DynamicSolver.h"
 #include "Types.h"
-#include "BIDP.h"
+#include "IncrementalBIDP.h"
 #include "QLearningSolver.h"
 #include <memory>
 
@@ -14,15 +14,18 @@ public:
     Direction getNextMove(const Position& current_pos, const Grid& current_grid); 
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    // The pre-trained Q-learner's.
+    const TrainingStats* getTrainingStats() const override { return rl_solver->getTrainingStats(); }
 
 private:
-    std::vector<StepReport> history;
+    TrajectoryRecorder history;
     Cost total_cost;
     EvacuationMode current_mode;
 
-    std::unique_ptr<QLearningSolver> rl_solver;
+    // planner is bound to current_grid, created on first use.
+    Direction nextMove(const Position& current_pos, const Grid& current_grid, std::unique_ptr<IncrementalBIDP>& planner);
 
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
+    std::unique_ptr<QLearningSolver> rl_solver;
 };
 
 #endif // ENMOD_HYBRID_DP_RL_SOLVER_H
\ No newline at end of file
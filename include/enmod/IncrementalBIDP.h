@@ -0,0 +1,61 @@
+#ifndef ENMOD_INCREMENTAL_BIDP_H
+#define ENMOD_INCREMENTAL_BIDP_H
+
+#include "Grid.h"
+#include "CostQueue.h"
+#include "CostFieldCache.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Backward cost-to-exit map (same values as BIDP) kept up to date across the
+// ticks of a simulation. It is bound to one live Grid; update() reads the
+// grid's changed-cell log and repairs only the cells whose cost depended on a
+// changed cell, so a tick without hazard changes costs nothing.
+// A change of cost ordering forces a full search.
+// Fields are looked up in and published to CostFieldCache::shared(), so
+// solvers replaying the same events share the work. A full search is
+// published straight away; a repaired field is published only once the
+// planner moves off it, so consecutive repairs modify one private copy
+// instead of copying the field every tick.
+class IncrementalBIDP {
+public:
+    explicit IncrementalBIDP(const Grid& grid_ref);
+    ~IncrementalBIDP();
+    IncrementalBIDP(const IncrementalBIDP&) = delete;
+    IncrementalBIDP& operator=(const IncrementalBIDP&) = delete;
+
+    void update(EvacuationMode mode);
+    const Grid& getGrid() const { return grid; }
+    // Indexed by Grid::toIndex(), like BIDP::getCostMap().
+    const std::vector<Cost>& getCostMap() const { return *field; }
+    Cost getCost(const Position& pos) const;
+
+private:
+    template <typename Order>
+    void solve(std::vector<Cost>& cost_map);
+    template <typename Order>
+    void repair(std::vector<Cost>& cost_map, size_t first_change);
+    template <typename Order>
+    void propagate(std::vector<Cost>& cost_map, CostQueue<Order>& pq);
+    // Hands the private field to the cache under the state it holds.
+    void publish();
+
+    // Per-cell flags. Exits are pinned by position, as in BIDP, even if a
+    // hazard later overwrites the cell type.
+    static constexpr std::uint8_t FLAG_EXIT = 1;
+    static constexpr std::uint8_t FLAG_AFFECTED = 2;
+
+    const Grid& grid;
+    // Published fields are never modified; the first repair of one copies it
+    // into owned, which later repairs update in place until publish().
+    CostFieldCache::Field field;
+    std::shared_ptr<std::vector<Cost>> owned;
+    CostFieldKey owned_key{0, EvacuationMode::NORMAL};
+    std::vector<std::uint8_t> flags;
+    std::vector<int> affected;
+    EvacuationMode solved_order = EvacuationMode::NORMAL;
+    size_t changes_seen = 0;
+};
+
+#endif // ENMOD_INCREMENTAL_BIDP_H
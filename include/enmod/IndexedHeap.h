@@ -0,0 +1,116 @@
+#ifndef ENMOD_INDEXED_HEAP_H
+#define ENMOD_INDEXED_HEAP_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Binary min-heap over dense integer ids (cell indices) with a position map,
+// so an id's key can be looked up, changed or removed in O(log n) instead of
+// rebuilding the queue. Each id is in the heap at most once. Entries with equal
+// keys pop in ascending id order, like a std::priority_queue of (key, id).
+template <typename Key, typename Less = std::less<Key>>
+class IndexedHeap {
+public:
+    // Empties the heap and accepts ids in [0, id_count).
+    void reset(int id_count) {
+        heap.clear();
+        slot.assign(id_count, -1);
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(int id) const { return slot[id] >= 0; }
+
+    int topId() const { return heap.front().second; }
+    const Key& topKey() const { return heap.front().first; }
+    const Key& keyOf(int id) const { return heap[slot[id]].first; }
+
+    // Inserts id, or moves it to its new key if it is already queued.
+    void push(int id, const Key& key) {
+        int i = slot[id];
+        if (i < 0) {
+            i = static_cast<int>(heap.size());
+            heap.push_back({key, id});
+            slot[id] = i;
+            siftUp(i);
+            return;
+        }
+        heap[i].first = key;
+        siftUp(i);
+        siftDown(slot[id]);
+    }
+
+    void pop() { removeAt(0); }
+
+    // Replaces every queued key with key_of(id) and restores heap order in
+    // O(n), cheaper than n pushes when all priorities move at once.
+    template <typename KeyOf>
+    void rekey(KeyOf&& key_of) {
+        for (auto& entry : heap) entry.first = key_of(entry.second);
+        for (int i = static_cast<int>(heap.size()) / 2 - 1; i >= 0; --i) siftDown(i);
+    }
+
+    // No-op if id is not queued.
+    void remove(int id) {
+        if (slot[id] >= 0) removeAt(slot[id]);
+    }
+
+private:
+    bool before(const std::pair<Key, int>& a, const std::pair<Key, int>& b) const {
+        if (less(a.first, b.first)) return true;
+        if (less(b.first, a.first)) return false;
+        return a.second < b.second;
+    }
+
+    void place(int i, std::pair<Key, int> entry) {
+        slot[entry.second] = i;
+        heap[i] = std::move(entry);
+    }
+
+    void siftUp(int i) {
+        std::pair<Key, int> entry = std::move(heap[i]);
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!before(entry, heap[parent])) break;
+            place(i, std::move(heap[parent]));
+            i = parent;
+        }
+        place(i, std::move(entry));
+    }
+
+    void siftDown(int i) {
+        const int n = static_cast<int>(heap.size());
+        std::pair<Key, int> entry = std::move(heap[i]);
+        while (true) {
+            int child = 2 * i + 1;
+            if (child >= n) break;
+            if (child + 1 < n && before(heap[child + 1], heap[child])) ++child;
+            if (!before(heap[child], entry)) break;
+            place(i, std::move(heap[child]));
+            i = child;
+        }
+        place(i, std::move(entry));
+    }
+
+    void removeAt(int i) {
+        slot[heap[i].second] = -1;
+        const int last = static_cast<int>(heap.size()) - 1;
+        if (i == last) {
+            heap.pop_back();
+            return;
+        }
+        const int moved = heap[last].second;
+        place(i, std::move(heap[last]));
+        heap.pop_back();
+        siftUp(i);
+        siftDown(slot[moved]);
+    }
+
+    std::vector<std::pair<Key, int>> heap;
+    // Heap position of each id, -1 when absent.
+    std::vector<int> slot;
+    Less less;
+};
+
+#endif // ENMOD_INDEXED_HEAP_H
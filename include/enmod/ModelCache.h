@@ -0,0 +1,72 @@
+#ifndef ENMOD_MODEL_CACHE_H
+#define ENMOD_MODEL_CACHE_H
+
+#include "Grid.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A trained model as flat arrays: value tables, critic values or network
+// weights as floats, visited flags as bytes.
+struct ModelData {
+    std::vector<std::vector<float>> floats;
+    std::vector<std::vector<std::uint8_t>> bytes;
+};
+
+// The array lengths a learner expects in its model, in the same order as
+// ModelData's arrays. A cached file with any other layout is not loaded.
+struct ModelLayout {
+    std::vector<std::uint64_t> floats;
+    std::vector<std::uint64_t> bytes;
+};
+
+// Builds the 64-bit key a model is cached under from everything its
+// training depends on.
+class ModelFingerprint {
+public:
+    // The grid's state hash and start position.
+    explicit ModelFingerprint(const Grid& grid);
+
+    ModelFingerprint& add(std::uint64_t value);
+    ModelFingerprint& add(double value);
+    std::uint64_t value() const { return hash; }
+
+private:
+    std::uint64_t hash;
+};
+
+// On-disk store of trained RL models, one file per model name and
+// fingerprint, so a learner trained once for a grid layout and set of
+// hyperparameters is loaded on later runs instead of retrained.
+// Files are a fixed header followed by 8-byte aligned sections of raw
+// arrays, so they can also be mapped straight into memory. Arrays are in the
+// writer's byte order; the header's magic number rejects the other one.
+// Files are written under a temporary name and renamed into place, so
+// concurrent runs never read a partial model.
+class ModelCache {
+public:
+    explicit ModelCache(std::string directory = "model_cache");
+
+    // Process-wide instance used by the learners; disabled until the
+    // application turns it on (main's --model-cache option).
+    static ModelCache& shared();
+
+    // False on a miss, or if the file is unreadable, truncated, from another
+    // format or not laid out as layout says; model is untouched then.
+    bool load(const std::string& name, std::uint64_t key, const ModelLayout& layout, ModelData& model) const;
+    // Best effort: a cache that cannot be written only costs retraining.
+    void store(const std::string& name, std::uint64_t key, const ModelData& model) const;
+
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+    bool isEnabled() const { return enabled; }
+    void setDirectory(const std::string& path) { directory = path; }
+    const std::string& getDirectory() const { return directory; }
+
+private:
+    std::string pathFor(const std::string& name, std::uint64_t key) const;
+
+    std::string directory;
+    bool enabled = false;
+};
+
+#endif // ENMOD_MODEL_CACHE_H
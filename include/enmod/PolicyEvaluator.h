@@ -0,0 +1,44 @@
+#ifndef ENMOD_POLICY_EVALUATOR_H
+#define ENMOD_POLICY_EVALUATOR_H
+
+#include "Grid.h"
+#include "Policy.h"
+#include <cstdint>
+#include <vector>
+
+// Where following a policy from a cell ends up.
+enum class PolicyOutcome : std::uint8_t {
+    REACHES_EXIT,
+    LOOPS,     // revisits a cell; STAY away from an exit counts as a loop
+    DEAD_END   // steps onto an unwalkable cell or has no action (NONE)
+};
+
+// Exact evaluation and analysis of a deterministic policy in O(N).
+// Each cell has a single successor, so the policy is a functional graph:
+// every path either reaches an exit, dead-ends, or runs into a cycle.
+// evaluate() follows each unvisited chain once, then assigns costs and
+// outcomes back along it, so every cell is visited a constant number of times.
+class PolicyEvaluator {
+public:
+    explicit PolicyEvaluator(const Grid& grid_ref);
+
+    // Cost of following the policy from each cell to an exit, indexed by
+    // Grid::toIndex(). Cells that loop or dead-end keep the default
+    // (unreachable) cost.
+    const std::vector<Cost>& evaluate(const Policy& policy);
+    const std::vector<Cost>& getValues() const { return values; }
+    // Indexed like the values; unwalkable cells are DEAD_END.
+    const std::vector<PolicyOutcome>& getOutcomes() const { return outcomes; }
+
+    Cost getValue(const Position& pos) const;
+    PolicyOutcome getOutcome(const Position& pos) const;
+
+private:
+    const Grid& grid;
+    std::vector<Cost> values;
+    std::vector<PolicyOutcome> outcomes;
+    std::vector<std::uint8_t> state;
+    std::vector<int> chain;
+};
+
+#endif // ENMOD_POLICY_EVALUATOR_H
@@ -6,14 +6,15 @@
 
 class PolicyGenerator : public Solver {
 public:
-    PolicyGenerator(const Grid& grid_ref);
+    // mode selects the cost ordering used to rank neighbours.
+    PolicyGenerator(const Grid& grid_ref, EvacuationMode mode = EvacuationMode::NORMAL);
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
     const Policy& getPolicy() const;
 
 private:
-    Cost calculatePolicyCost() const;
+    EvacuationMode mode;
     Policy policy;
     Cost final_cost;
 };
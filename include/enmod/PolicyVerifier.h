@@ -14,7 +14,6 @@ public:
 
 private:
     bool is_regular;
-    bool isPathRegular(const Position& start_pos, const Policy& policy) const;
 };
 
 #endif // ENMOD_POLICY_VERIFIER_H
@@ -11,8 +11,8 @@ public:
     void generateReport(std::ofstream& report_file) const override;
     
     void train(int episodes) override;
-    Direction chooseAction(const Position& state) override;
-    void update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) override;
+    Direction sampleAction(int state, std::mt19937& rng) override;
+    void update(int s, Direction a, double r, int s_next, Direction a_next) override;
 };
 
 #endif // ENMOD_Q_LEARNING_SOLVER_H
\ No newline at end of file
@@ -13,14 +13,14 @@ public:
     void run() override;
     Cost getEvacuationCost() const override;
     void generateReport(std::ofstream& report_file) const override;
+    // The pre-trained Q-learner's.
+    const TrainingStats* getTrainingStats() const override { return rl_solver->getTrainingStats(); }
 
 private:
-    std::vector<StepReport> history;
+    TrajectoryRecorder history;
     Cost total_cost;
     EvacuationMode current_mode;
     std::unique_ptr<QLearningSolver> rl_solver;
-
-    void assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid);
 };
 
 #endif // ENMOD_RL_ENHANCED_ASTAR_SOLVER_H
\ No newline at end of file
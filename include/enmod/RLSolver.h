@@ -2,30 +2,118 @@
 #define ENMOD_RL_SOLVER_H
 
 #include "Solver.h"
+#include "ModelCache.h"
 #include "Policy.h"
+#include "TabularMDP.h"
+#include "ValueTable.h"
+#include <random>
 #include <vector>
-#include <map>
 
-using ValueTable = std::map<Position, std::vector<double>>;
+// When train() may stop before its episode cap. The check runs after every
+// window of check_interval episodes.
+struct ConvergenceCriterion {
+    enum class Kind {
+        NONE,           // always train to the cap
+        VALUE_DELTA,    // max |delta Q| over a window is at most tolerance
+        POLICY_STABLE,  // the greedy policy is unchanged for stable_windows windows
+        REFERENCE_COST  // the greedy policy's cost from the start is no worse than reference
+    };
+    Kind kind = Kind::NONE;
+    int check_interval = 250;
+    double tolerance = 1.0;
+    int stable_windows = 3;
+    Cost reference;
+
+    static ConvergenceCriterion valueDelta(double tolerance);
+    static ConvergenceCriterion policyStable(int stable_windows);
+    static ConvergenceCriterion referenceCost(const Cost& reference);
+};
+
+// Turns a BIDP cost-to-go into a discounted return for warm starts. A cell
+// d steps from an exit is valued as if the remaining path paid exit_reward
+// on its last step and an equal share of the weighted cost fields on each
+// step before it. Cells with no route to an exit are valued as wandering
+// forever at per_distance a step.
+struct CostToReturn {
+    double exit_reward = 1000;
+    double per_smoke = -4;
+    double per_time = 0;
+    double per_distance = -1;
+};
 
 class RLSolver : public Solver {
 public:
-    RLSolver(const Grid& grid_ref, const std::string& name);
+    // initial_value is what every action of an unvisited state starts at.
+    RLSolver(const Grid& grid_ref, const std::string& name, float initial_value = 0.0f);
     
     void run() override; // Main training loop for static solvers
 
-    // RL-specific methods for learning
-    virtual void update(const Position& s, Direction a, double r, const Position& s_next, Direction a_next) = 0;
-    virtual Direction chooseAction(const Position& state) = 0;
+    // RL-specific methods for learning. States are cell indices (Grid::toIndex()).
+    // update() and sampleAction() may run on several training threads at
+    // once; they share the value table and draw only from the rng passed in.
+    virtual void update(int s, Direction a, double r, int s_next, Direction a_next) = 0;
+    virtual Direction sampleAction(int state, std::mt19937& rng) = 0;
+    // Single-threaded use, with the solver's own generator.
+    Direction chooseAction(int state) { return sampleAction(state, rng); }
     const Policy& getPolicy(); 
     const ValueTable& getPolicyValueTable() const { return value_table; }
 
+    // Worker threads for train(); 0 picks one per core.
+    void setTrainingThreads(int threads) { training_threads = threads; }
+    void setConvergence(const ConvergenceCriterion& criterion) { convergence = criterion; }
+    // Whether pretrain() seeds the value table from BIDP (the default) or
+    // starts from the uniform initial value.
+    void setWarmStart(bool enabled, const CostToReturn& mapping = {}) {
+        warm_start = enabled;
+        cost_to_return = mapping;
+    }
+
+    // Seeds the learner from a cost field indexed by Grid::toIndex(), such as
+    // BIDP::getCostMap(); unwalkable cells are left alone.
+    void warmStart(const std::vector<Cost>& cost_map, const CostToReturn& mapping = {});
+    // Runs BIDP once, warm-starts from its cost field if enabled, then trains
+    // at most episodes episodes until the greedy policy is as good as BIDP's.
+    // The result is kept in ModelCache::shared(), and later runs on the same
+    // grid with the same settings load it instead.
+    void pretrain(int episodes);
+    // Of the latest train() call.
+    const TrainingStats* getTrainingStats() const override { return &training_stats; }
+
 protected:
     void generatePolicyFromValueTable();
+    void writeTrainingSummary(std::ofstream& report_file) const;
+    // Sets the learner's tables from per-cell state values. By default each
+    // action gets its reward plus the discounted value of where it leads.
+    virtual void seedValues(const std::vector<double>& state_values);
+    // The learned tables as cache sections, and back; modelLayout() gives the
+    // section lengths, so restoreModel() only sees models that fit this grid.
+    virtual ModelLayout modelLayout() const;
+    virtual void saveModel(ModelData& model) const;
+    virtual void restoreModel(const ModelData& model);
+    // Runs up to episodes episodes, stopping early once the convergence
+    // criterion holds. Each window runs Hogwild-style: workers share the
+    // value table without locks, each with its own generator.
     virtual void train(int episodes); 
+    void runParallel(int episodes);
+    void runEpisodes(int episodes, std::mt19937& episode_rng);
+    bool hasConverged();
 
+    // Compiled from the static grid; episodes step through it.
+    TabularMDP mdp;
+    float initial_value;
     ValueTable value_table;
     Policy policy;
+    std::mt19937 rng;
+    int training_threads = 0;
+    ConvergenceCriterion convergence;
+    bool warm_start = true;
+    CostToReturn cost_to_return;
+    TrainingStats training_stats;
+    // The previous window's values or greedy actions, for the delta and
+    // stability criteria.
+    std::vector<float> window_values;
+    std::vector<int> window_actions;
+    int stable_count = 0;
     
     double alpha = 0.1;
     double gamma = 0.9;
@@ -0,0 +1,86 @@
+#ifndef ENMOD_RADIX_HEAP_H
+#define ENMOD_RADIX_HEAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Monotone priority queue over unsigned 64-bit keys (radix heap).
+// Valid whenever every pushed key is >= the last popped key, which holds for
+// Dijkstra with non-negative edge costs and for A* with a consistent heuristic.
+// push() is O(1) outside the last popped key and O(log k) on it, where k is
+// the number of entries sharing that key; pop() is O(log C + log k)
+// amortised, where C is the key range.
+// Entries with equal keys pop in ascending Value order, so searches break ties
+// deterministically (by cell index or Position) just like a (key, value) heap.
+template <typename Value>
+class RadixHeap {
+public:
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(std::uint64_t key, const Value& value) {
+        size_t b = bucketFor(key);
+        buckets[b].push_back({key, value});
+        // Bucket 0 is a binary heap on Value, so long runs of equal keys (the
+        // f plateaus of A*) cost log k per entry instead of a sorted insert.
+        if (b == 0) std::push_heap(buckets[0].begin(), buckets[0].end(), laterValue);
+        ++count;
+    }
+
+    std::pair<std::uint64_t, Value> pop() {
+        if (buckets[0].empty()) {
+            size_t i = 1;
+            while (buckets[i].empty()) ++i;
+            // Move up to the smallest key in the first non-empty bucket and
+            // redistribute that bucket; all its entries land in lower buckets.
+            std::uint64_t new_last = buckets[i][0].first;
+            for (const auto& entry : buckets[i]) {
+                if (entry.first < new_last) new_last = entry.first;
+            }
+            last = new_last;
+            for (const auto& entry : buckets[i]) buckets[bucketFor(entry.first)].push_back(entry);
+            buckets[i].clear();
+            std::make_heap(buckets[0].begin(), buckets[0].end(), laterValue);
+        }
+        std::pop_heap(buckets[0].begin(), buckets[0].end(), laterValue);
+        std::pair<std::uint64_t, Value> top = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return top;
+    }
+
+    void clear() {
+        for (auto& bucket : buckets) bucket.clear();
+        last = 0;
+        count = 0;
+    }
+
+private:
+    // Heap order that puts the smallest Value on top.
+    static bool laterValue(const std::pair<std::uint64_t, Value>& a, const std::pair<std::uint64_t, Value>& b) {
+        return b.second < a.second;
+    }
+
+    // Bucket 0 holds keys equal to the last popped key; bucket b holds keys
+    // whose highest bit differing from it is bit b - 1.
+    size_t bucketFor(std::uint64_t key) const {
+        std::uint64_t diff = key ^ last;
+        if (diff == 0) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+        return 64 - __builtin_clzll(diff);
+#else
+        size_t bits = 0;
+        while (diff) { ++bits; diff >>= 1; }
+        return bits;
+#endif
+    }
+
+    std::array<std::vector<std::pair<std::uint64_t, Value>>, 65> buckets;
+    std::uint64_t last = 0;
+    size_t count = 0;
+};
+
+#endif // ENMOD_RADIX_HEAP_H
@@ -0,0 +1,50 @@
+#ifndef ENMOD_SEARCH_WORKSPACE_H
+#define ENMOD_SEARCH_WORKSPACE_H
+
+#include "Grid.h"
+#include "RadixHeap.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Per-cell state for the A* family, reused across calls and ticks.
+// Arrays are indexed by Grid::toIndex(). A generation stamp marks the cells the
+// current search has reached, so begin() resets in O(1) instead of clearing
+// every array, and all buffers keep their capacity: once warmed up, a
+// workspace searches without allocating.
+class SearchWorkspace {
+public:
+    // Starts a new search; the arrays only grow when the grid has more cells.
+    void begin(const Grid& grid);
+
+    bool reached(int idx) const { return stamp[idx] == generation; }
+    // Unreached cells report the default (unreachable) cost.
+    const Cost& g(int idx) const { return reached(idx) ? g_score[idx] : unreached; }
+    int parent(int idx) const { return reached(idx) ? came_from[idx] : -1; }
+    void reach(int idx, const Cost& cost, int parent_idx) {
+        stamp[idx] = generation;
+        g_score[idx] = cost;
+        came_from[idx] = parent_idx;
+    }
+
+    // Cells from the search's root to idx, following parents.
+    const std::vector<Position>& tracePath(const Grid& grid, int idx);
+    const std::vector<Position>& emptyPath() { path.clear(); return path; }
+
+    // Open lists, emptied by begin(). The radix heap suits monotone keys; the
+    // binary heap (std::push_heap/pop_heap) takes any double priority.
+    RadixHeap<int>& radixQueue() { return radix; }
+    std::vector<std::pair<double, int>>& heapQueue() { return heap; }
+
+private:
+    std::uint32_t generation = 0;
+    std::vector<std::uint32_t> stamp;
+    std::vector<Cost> g_score;
+    std::vector<int> came_from;
+    std::vector<Position> path;
+    RadixHeap<int> radix;
+    std::vector<std::pair<double, int>> heap;
+    Cost unreached;
+};
+
+#endif // ENMOD_SEARCH_WORKSPACE_H
@@ -6,6 +6,21 @@
     #include <vector>
     #include <fstream> 
     
+    // How a learning solver's training went: episodes actually run against
+    // the cap it was given, and the wall time until it stopped.
+    struct TrainingStats {
+        int episodes = 0;
+        int episode_cap = 0;
+        double time_ms = 0;
+        // Whether a convergence criterion was checked, and whether it held.
+        bool early_stopping = false;
+        bool converged = false;
+        // Loaded from the model cache instead of trained. The fields above
+        // then describe the run that trained the cached model.
+        bool cached = false;
+        double load_ms = 0;
+    };
+    
     class Solver {
     public:
         Solver(const Grid& grid_ref, const std::string& name);
@@ -14,6 +29,8 @@
         virtual void run() = 0;
         virtual Cost getEvacuationCost() const = 0;
         virtual void generateReport(std::ofstream& report_file) const = 0;
+        // Null for solvers that do not train.
+        virtual const TrainingStats* getTrainingStats() const { return nullptr; }
     
         const std::string& getName() const;
     
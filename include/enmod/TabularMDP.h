@@ -0,0 +1,40 @@
+#ifndef ENMOD_TABULAR_MDP_H
+#define ENMOD_TABULAR_MDP_H
+
+#include "Grid.h"
+#include <cstdint>
+#include <vector>
+
+// The evacuation MDP the tabular learners train on, compiled to flat arrays
+// so a rollout step is three loads instead of walkability, exit and cell
+// type checks on the grid. States are cell indices (Grid::toIndex()) and
+// actions are the four moves in Direction order.
+// A move into a wall keeps the agent in place for -100; entering an exit pays
+// 1000 and ends the episode, fire costs -200, smoke -20 and any other cell -1.
+// update() re-patches only the cells around the grid's change log, so the
+// tables can follow a live grid through its hazard events.
+class TabularMDP {
+public:
+    static constexpr int ACTIONS = 4;
+
+    explicit TabularMDP(const Grid& grid_ref);
+
+    // Catches the tables up with cells changed since the last call.
+    void update();
+
+    int next(int idx, int action) const { return next_state[static_cast<size_t>(idx) * ACTIONS + action]; }
+    float reward(int idx, int action) const { return rewards[static_cast<size_t>(idx) * ACTIONS + action]; }
+    bool isTerminal(int idx) const { return terminal[idx] != 0; }
+
+private:
+    void compile(int idx);
+
+    const Grid& grid;
+    size_t changes_seen = 0;
+
+    std::vector<int> next_state;
+    std::vector<float> rewards;
+    std::vector<std::uint8_t> terminal;
+};
+
+#endif // ENMOD_TABULAR_MDP_H
@@ -0,0 +1,39 @@
+#ifndef ENMOD_THREAT_MAP_H
+#define ENMOD_THREAT_MAP_H
+
+#include "Types.h"
+#include <cstdint>
+#include <vector>
+
+// Per-cell evacuation mode, kept up to date by Grid as hazards are applied.
+// Uses the same padded, row-major indexing as Grid::toIndex().
+//  - within distance 1 of a burning cell: PANIC
+//  - within a burning cell's radius: ALERT
+//  - next to a heavy-smoke cell: ALERT
+class ThreatMap {
+public:
+    ThreatMap() = default;
+    ThreatMap(int rows, int cols);
+
+    EvacuationMode getMode(int idx) const {
+        std::uint8_t fire = fire_mode[idx];
+        if (fire == PANIC_LEVEL || heavy_smoke_neighbors[idx] == 0) return static_cast<EvacuationMode>(fire);
+        return EvacuationMode::ALERT;
+    }
+
+    void addFire(const Position& pos, int radius);
+    void clearFires();
+    // Call only when a cell's heavy-smoke state actually changes.
+    void setHeavySmoke(int idx, bool heavy);
+
+private:
+    static constexpr std::uint8_t PANIC_LEVEL = static_cast<std::uint8_t>(EvacuationMode::PANIC);
+
+    int rows = 0;
+    int cols = 0;
+    int stride = 0;
+    std::vector<std::uint8_t> fire_mode;
+    std::vector<std::uint8_t> heavy_smoke_neighbors;
+};
+
+#endif // ENMOD_THREAT_MAP_H
@@ -0,0 +1,77 @@
+#ifndef ENMOD_TIME_EXPANDED_PLANNER_H
+#define ENMOD_TIME_EXPANDED_PLANNER_H
+
+#include "Grid.h"
+#include <cstdint>
+#include <vector>
+
+// Space-time DP over (cell, tick) for a grid whose hazard schedule is known up
+// front. After the last event the grid stops changing and the cost-to-exit is
+// a static backward Dijkstra field; backward induction runs from that tick down
+// to 0 using the grid state of each tick, as a simulator sees it (events due at
+// t already applied, and an exit that caught fire no longer counts). Only the
+// final grid state is kept whole; induction walks back through earlier states
+// by undoing each event tick's changed cells. Consecutive ticks whose layers
+// agree on every cell reachable by then share one stored layer, and once that
+// happens between two events, the rest of the event-free stretch shares it too
+// without being stepped.
+// After solve(), every (cell, tick) lookup is O(1).
+// The plan minimises total cost under a single cost ordering, fixed by mode.
+class TimeExpandedPlanner {
+public:
+    explicit TimeExpandedPlanner(const Grid& grid_ref, EvacuationMode mode = EvacuationMode::NORMAL);
+
+    void solve();
+    // Action to take at pos on tick t; NONE where no exit can be reached or,
+    // up to the horizon, pos is more than t steps from the start. Ticks past
+    // the horizon use the stationary layer, which covers every cell.
+    Direction getAction(const Position& pos, int t) const;
+    // Cost of following the plan from pos on tick t to an exit.
+    Cost getCost(const Position& pos, int t) const;
+    // Last tick with its own layer: the last event tick, capped by the
+    // simulators' tick limit.
+    int getHorizon() const { return horizon; }
+    size_t getLayerCount() const { return layers.size(); }
+
+private:
+    struct Layer {
+        std::vector<Cost> values;
+        std::vector<Direction> actions;
+    };
+    // Per-cell flags of the grid state on the tick being stepped.
+    static constexpr std::uint8_t CELL_WALKABLE = 1;
+    static constexpr std::uint8_t CELL_EXIT = 2;
+    struct CellState {
+        std::vector<std::uint8_t> flags;
+        std::vector<Cost> move_costs;
+    };
+    // A cell as it was before an event tick changed it.
+    struct CellUndo {
+        int idx;
+        std::uint8_t flags;
+        Cost move_cost;
+    };
+
+    template <typename Order>
+    void build(const Grid& final_state, CellState& cells, const std::vector<int>& state_start,
+               const std::vector<CellUndo>& undo, const std::vector<size_t>& undo_begin);
+    template <typename Order>
+    void staticField(const Grid& state, std::vector<Cost>& values) const;
+    template <typename Order>
+    void step(const CellState& cells, int t, const std::vector<Cost>& next_values, Layer& layer) const;
+    // Whether two layers agree on every cell within t steps of the start.
+    bool sameWithin(const Layer& a, const Layer& b, int t) const;
+    const Layer* layerAt(const Position& pos, int t) const;
+
+    const Grid& grid;
+    EvacuationMode mode;
+    int horizon = 0;
+    std::vector<Layer> layers;
+    // Greedy descent on the final state's static field, for every tick
+    // after the horizon.
+    Layer stationary;
+    // Index into layers for each tick in [0, horizon].
+    std::vector<int> layer_at;
+};
+
+#endif // ENMOD_TIME_EXPANDED_PLANNER_H
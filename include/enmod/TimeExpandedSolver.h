@@ -0,0 +1,24 @@
+#ifndef ENMOD_TIME_EXPANDED_SOLVER_H
+#define ENMOD_TIME_EXPANDED_SOLVER_H
+
+#include "DynamicSolver.h"
+#include "Types.h"
+#include "TimeExpandedPlanner.h"
+
+// Dynamic simulator that plans once against the whole event schedule
+// (TimeExpandedPlanner) and then only looks up its action on each tick.
+class TimeExpandedSolver : public Solver {
+public:
+    TimeExpandedSolver(const Grid& grid_ref);
+    void run() override;
+    Cost getEvacuationCost() const override;
+    void generateReport(std::ofstream& report_file) const override;
+
+private:
+    TimeExpandedPlanner planner;
+    TrajectoryRecorder history;
+    Cost total_cost;
+    EvacuationMode current_mode;
+};
+
+#endif // ENMOD_TIME_EXPANDED_SOLVER_H
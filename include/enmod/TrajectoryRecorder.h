@@ -0,0 +1,46 @@
+#ifndef ENMOD_TRAJECTORY_RECORDER_H
+#define ENMOD_TRAJECTORY_RECORDER_H
+
+#include "Grid.h"
+#include "Cost.h"
+#include "Types.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct StepReport {
+    int time_step;
+    Position agent_pos;
+    std::string action;
+    Cost current_total_cost;
+    EvacuationMode mode;
+    size_t event_end; // Recorded events applied to the grid as of this step
+};
+
+// Simulation history stored as one base grid plus the hazard events applied
+// between steps, instead of a full Grid copy per step. A step's grid is
+// rebuilt on demand by replaying events onto the base.
+// Relies on the grid changing only through Grid::applyEvent() while recording.
+class TrajectoryRecorder {
+public:
+    void record(int time_step, const Grid& grid, const Position& agent_pos,
+                const std::string& action, const Cost& total_cost, EvacuationMode mode);
+    void clear();
+
+    bool empty() const { return steps.empty(); }
+    size_t size() const { return steps.size(); }
+    StepReport& back() { return steps.back(); }
+    const StepReport& back() const { return steps.back(); }
+
+    // Calls visit(step, grid_state) for every step in order.
+    void replay(const std::function<void(const StepReport&, const Grid&)>& visit) const;
+
+private:
+    std::unique_ptr<Grid> base_grid;
+    size_t base_journal_size = 0; // Grid journal length when base_grid was taken
+    std::vector<TimedEvent> events;
+    std::vector<StepReport> steps;
+};
+
+#endif // ENMOD_TRAJECTORY_RECORDER_H
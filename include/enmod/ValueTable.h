@@ -0,0 +1,68 @@
+#ifndef ENMOD_VALUE_TABLE_H
+#define ENMOD_VALUE_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Dense per-state action values for the tabular learners: one row of
+// ACTIONS floats per cell, indexed by Grid::toIndex() and the Direction of
+// the action. States the learner has not visited yet read as the initial
+// value and report contains() == false, so "no entry" keeps its meaning
+// without a map lookup or allocation per state.
+// Entries are relaxed atomics so training threads can share one table
+// Hogwild-style: reads and writes never tear, concurrent updates to the
+// same entry may overwrite each other, and neither costs more than a plain
+// load or store.
+class ValueTable {
+public:
+    static constexpr int ACTIONS = 4;
+
+    ValueTable() = default;
+    ValueTable(int cell_count, float initial_value) { reset(cell_count, initial_value); }
+
+    void reset(int cell_count, float initial_value) {
+        values = std::vector<std::atomic<float>>(static_cast<size_t>(cell_count) * ACTIONS);
+        for (auto& value : values) value.store(initial_value, std::memory_order_relaxed);
+        visited = std::vector<std::atomic<std::uint8_t>>(cell_count);
+    }
+
+    int cellCount() const { return static_cast<int>(visited.size()); }
+    bool contains(int idx) const { return visited[idx].load(std::memory_order_relaxed) != 0; }
+    // Marks the state visited, like inserting it with the initial values.
+    void touch(int idx) {
+        if (!contains(idx)) visited[idx].store(1, std::memory_order_relaxed);
+    }
+
+    float get(int idx, int action) const { return entry(idx, action).load(std::memory_order_relaxed); }
+    void set(int idx, int action, float value) { entry(idx, action).store(value, std::memory_order_relaxed); }
+
+    // First action with the highest value.
+    int bestAction(int idx) const {
+        int best = 0;
+        float best_value = get(idx, 0);
+        for (int a = 1; a < ACTIONS; ++a) {
+            float value = get(idx, a);
+            if (value > best_value) {
+                best = a;
+                best_value = value;
+            }
+        }
+        return best;
+    }
+    float maxValue(int idx) const {
+        float best_value = get(idx, 0);
+        for (int a = 1; a < ACTIONS; ++a) best_value = std::max(best_value, get(idx, a));
+        return best_value;
+    }
+
+private:
+    std::atomic<float>& entry(int idx, int action) { return values[static_cast<size_t>(idx) * ACTIONS + action]; }
+    const std::atomic<float>& entry(int idx, int action) const { return values[static_cast<size_t>(idx) * ACTIONS + action]; }
+
+    std::vector<std::atomic<float>> values;
+    std::vector<std::atomic<std::uint8_t>> visited;
+};
+
+#endif // ENMOD_VALUE_TABLE_H
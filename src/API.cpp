@@ -1,10 +1,11 @@
 #include "enmod/API.h"
 #include "enmod/Logger.h"
+#include "enmod/PolicyEvaluator.h"
 #include <vector>
 #include <algorithm>
 #include <fstream>
 
-API::API(const Grid& grid_ref) : Solver(grid_ref, "API"), policy(grid_ref.getRows(), grid_ref.getCols()) {}
+API::API(const Grid& grid_ref, EvacuationMode mode) : Solver(grid_ref, "API"), mode(mode), policy(grid_ref.getRows(), grid_ref.getCols()) {}
 
 void API::run() {
     if (grid.getExitPositions().empty()) return;
@@ -19,6 +20,7 @@ void API::run() {
         }
     }
 
+    PolicyEvaluator evaluator(grid);
     bool policy_stable = false;
     int iteration = 0;
     while (!policy_stable) {
@@ -29,25 +31,8 @@ void API::run() {
              break;
         }
 
-        std::vector<std::vector<Cost>> value_map(grid.getRows(), std::vector<Cost>(grid.getCols()));
-        for (const auto& exit_pos : grid.getExitPositions()) {
-            value_map[exit_pos.row][exit_pos.col] = {0, 0, 0};
-        }
-        
-        for(int i = 0; i < grid.getRows() * grid.getCols(); ++i){
-             for (int r = 0; r < grid.getRows(); ++r) {
-                for (int c = 0; c < grid.getCols(); ++c) {
-                    if(grid.isWalkable(r,c) && !grid.isExit(r,c)){
-                        Position current_pos = {r,c};
-                        Direction dir = policy.getDirection(current_pos);
-                        Position next_pos = grid.getNextPosition(current_pos, dir);
-                        if(grid.isWalkable(next_pos.row, next_pos.col)){
-                            value_map[r][c] = grid.getMoveCost(current_pos) + value_map[next_pos.row][next_pos.col];
-                        }
-                    }
-                }
-            }
-        }
+        // Exact evaluation of the current policy in one pass.
+        const std::vector<Cost>& value_map = evaluator.evaluate(policy);
 
         for (int r = 0; r < grid.getRows(); ++r) {
             for (int c = 0; c < grid.getCols(); ++c) {
@@ -62,8 +47,8 @@ void API::run() {
                     for(auto dir : dirs){
                         Position neighbor = grid.getNextPosition(current_pos, dir);
                         if(grid.isWalkable(neighbor.row, neighbor.col)){
-                            Cost action_cost = grid.getMoveCost(current_pos) + value_map[neighbor.row][neighbor.col];
-                            if(action_cost < best_cost){
+                            Cost action_cost = grid.getMoveCost(current_pos) + value_map[grid.toIndex(neighbor)];
+                            if(costLess(mode, action_cost, best_cost)){
                                 best_cost = action_cost;
                                 best_direction = dir;
                             }
@@ -78,36 +63,20 @@ void API::run() {
             }
         }
     }
-}
 
-Cost API::getEvacuationCost() const {
-    return calculatePolicyCost();
+    evaluator.evaluate(policy);
+    Position start_pos = grid.getStartPosition();
+    final_cost = evaluator.getValue(start_pos);
+    PolicyOutcome outcome = evaluator.getOutcome(start_pos);
+    if (outcome == PolicyOutcome::LOOPS) {
+        Logger::log(LogLevel::ERROR, "Loop detected in API policy. Returning infinite cost.");
+    } else if (outcome == PolicyOutcome::DEAD_END) {
+        Logger::log(LogLevel::ERROR, "API policy failed to find exit. Returning infinite cost.");
+    }
 }
 
-Cost API::calculatePolicyCost() const {
-    Position current = grid.getStartPosition();
-    Cost total_cost = {0, 0, 0};
-    std::vector<Position> path;
-
-    for (int i = 0; i < grid.getRows() * grid.getCols() + 1; ++i) {
-        path.push_back(current);
-        if (grid.isExit(current.row, current.col)) {
-            return total_cost;
-        }
-
-        Direction dir = policy.getDirection(current);
-        total_cost = total_cost + grid.getMoveCost(current);
-        current = grid.getNextPosition(current, dir);
-
-        for (const auto& p : path) {
-            if (p == current) {
-                Logger::log(LogLevel::ERROR, "Loop detected in API policy. Returning infinite cost.");
-                return {}; 
-            }
-        }
-    }
-    Logger::log(LogLevel::ERROR, "API policy failed to find exit. Returning infinite cost.");
-    return {}; 
+Cost API::getEvacuationCost() const {
+    return final_cost;
 }
 
 void API::generateReport(std::ofstream& report_file) const {
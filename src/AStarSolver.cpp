@@ -1,71 +1,54 @@
 #include "enmod/AStarSolver.h"
-#include <queue>
+#include "enmod/GridHeuristics.h"
+#include "enmod/RadixHeap.h"
+#include "enmod/SearchWorkspace.h"
 #include <vector>
-#include <map>
 #include <cmath>
 #include <algorithm>
 
-// A* Node for the priority queue
-struct AStarNode {
-    Position pos;
-    Cost cost;
-    double heuristic;
-
-    bool operator>(const AStarNode& other) const {
-        return (cost.time + heuristic) > (other.cost.time + other.heuristic);
-    }
-};
-
 AStarSolver::AStarSolver(const Grid& grid_ref) : Solver(grid_ref, "AStar") {}
 
 void AStarSolver::run() {
-    std::priority_queue<AStarNode, std::vector<AStarNode>, std::greater<AStarNode>> open_set;
-    std::map<Position, Position> came_from;
-    std::map<Position, Cost> g_score;
-
     Position start_pos = grid.getStartPosition();
-    g_score[start_pos] = {0, 0, 0};
+    GridHeuristics heuristics(grid);
+    SearchWorkspace workspace;
+    // f = g.time + h never decreases during the search: h is the step distance
+    // to the nearest exit around walls and every step costs at least one time
+    // unit. That makes the open set a monotone queue, so a radix heap can
+    // replace the binary heap.
+    workspace.begin(grid);
+    RadixHeap<int>& open_set = workspace.radixQueue();
+    const auto& offsets = grid.getNeighborOffsets();
 
-    auto heuristic = [&](const Position& p) {
-        double h = std::numeric_limits<double>::max();
-        for (const auto& exit_pos : grid.getExitPositions()) {
-            h = std::min(h, (double)std::abs(p.row - exit_pos.row) + std::abs(p.col - exit_pos.col));
-        }
-        return h;
-    };
+    if (grid.getExitPositions().empty()) return;
 
-    open_set.push({start_pos, {0, 0, 0}, heuristic(start_pos)});
+    int start_idx = grid.toIndex(start_pos);
+    if (heuristics.exitDistance(start_idx) == GridHeuristics::UNREACHABLE) return;
+    workspace.reach(start_idx, {0, 0, 0}, -1);
+    open_set.push(heuristics.exitDistance(start_idx), start_idx);
 
     while (!open_set.empty()) {
-        Position current = open_set.top().pos;
-        open_set.pop();
+        auto [f_score, current] = open_set.pop();
+        const Cost current_g = workspace.g(current);
+        // A later, faster route to this cell was already expanded from a smaller key.
+        if (f_score > static_cast<std::uint64_t>(current_g.time + heuristics.exitDistance(current))) {
+            continue;
+        }
 
-        if (grid.isExit(current.row, current.col)) {
-            // Reconstruct path
-            Position temp = current;
-            while (came_from.count(temp)) {
-                path.push_back(temp);
-                temp = came_from[temp];
-            }
-            path.push_back(start_pos);
-            std::reverse(path.begin(), path.end());
-            total_cost = g_score[current];
+        if (grid.isExitAt(current)) {
+            path = workspace.tracePath(grid, current);
+            total_cost = current_g;
             return;
         }
 
-        int dr[] = {-1, 1, 0, 0};
-        int dc[] = {0, 0, -1, 1};
-
-        for (int i = 0; i < 4; ++i) {
-            Position neighbor = {current.row + dr[i], current.col + dc[i]};
-
-            if (grid.isWalkable(neighbor.row, neighbor.col)) {
-                Cost tentative_g_score = g_score[current] + grid.getMoveCost(neighbor);
-
-                if (!g_score.count(neighbor) || tentative_g_score < g_score[neighbor]) {
-                    came_from[neighbor] = current;
-                    g_score[neighbor] = tentative_g_score;
-                    open_set.push({neighbor, tentative_g_score, heuristic(neighbor)});
+        for (int offset : offsets) {
+            int neighbor = current + offset;
+            // Cells that cannot reach an exit are never worth queueing.
+            if (grid.isWalkableAt(neighbor) && heuristics.exitDistance(neighbor) != GridHeuristics::UNREACHABLE) {
+                Cost tentative_g_score = current_g + grid.getMoveCostAt(neighbor);
+                if (!workspace.reached(neighbor) || LexTimeFirst::less(tentative_g_score, workspace.g(neighbor))) {
+                    workspace.reach(neighbor, tentative_g_score, current);
+                    open_set.push(tentative_g_score.time + heuristics.exitDistance(neighbor), neighbor);
                 }
             }
         }
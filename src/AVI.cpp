@@ -1,56 +1,194 @@
 #include "enmod/AVI.h"
+#include "enmod/CostQueue.h"
 #include "enmod/Logger.h"
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
+#include <limits>
+#include <mutex>
+#include <thread>
 
-AVI::AVI(const Grid& grid_ref) : Solver(grid_ref, "AVI") {}
+namespace {
+// Packed value of an unreachable cell. Keys use at most 62 bits, so adding a
+// step key to it cannot overflow and the sum clamps back to it.
+constexpr std::uint64_t INF_KEY = std::numeric_limits<std::uint64_t>::max() / 2;
 
-const std::vector<std::vector<Cost>>& AVI::getCostMap() const {
+// Grids smaller than this are swept on the calling thread.
+constexpr int PARALLEL_MIN_CELLS = 128 * 128;
+constexpr int MIN_ROWS_PER_THREAD = 32;
+
+// Reusable barrier for the sweep workers (std::barrier is C++20).
+class SweepBarrier {
+public:
+    explicit SweepBarrier(int count) : count(count) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        int gen = generation;
+        if (++arrived == count) {
+            arrived = 0;
+            ++generation;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return gen != generation; });
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    int count;
+    int arrived = 0;
+    int generation = 0;
+};
+
+// Relaxes the cells of one colour ((row + col) % 2) in rows [row_begin, row_end).
+// Cells of a colour only read cells of the other, so the update order within a
+// colour does not matter and the loop body is branch-free. Fixed cells (walls
+// and exits) have an INF_KEY step and never change. Returns the number of
+// improved cells.
+size_t relaxColour(std::uint64_t* value, const std::uint64_t* step, int stride, int cols,
+                   int row_begin, int row_end, int colour) {
+    size_t improved = 0;
+    for (int r = row_begin; r < row_end; ++r) {
+        std::uint64_t* v = value + (r + 1) * stride + 1;
+        const std::uint64_t* w = step + (r + 1) * stride + 1;
+        for (int c = (r + colour) & 1; c < cols; c += 2) {
+            std::uint64_t best = std::min(std::min(v[c - stride], v[c + stride]), std::min(v[c - 1], v[c + 1]));
+            std::uint64_t candidate = std::min(best + w[c], INF_KEY);
+            improved += candidate < v[c];
+            v[c] = std::min(v[c], candidate);
+        }
+    }
+    return improved;
+}
+
+int sweepThreadCount(int rows, int cols) {
+    if (rows * cols < PARALLEL_MIN_CELLS) return 1;
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, std::min(hardware, rows / MIN_ROWS_PER_THREAD));
+}
+}
+
+AVI::AVI(const Grid& grid_ref, EvacuationMode mode) : Solver(grid_ref, "AVI"), mode(mode) {}
+
+const std::vector<Cost>& AVI::getCostMap() const {
     return cost_map;
 }
 
 void AVI::run() {
-    cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
+    withCostOrder(mode, [this](auto order) {
+        CostKey key(grid, decltype(order)::fields);
+        if (key.bits() <= 62) iteratePacked(key);
+        else iterate<decltype(order)>();
+    });
+}
+
+void AVI::iteratePacked(const CostKey& key) {
+    const int rows = grid.getRows();
+    const int cols = grid.getCols();
+    const int stride = grid.getStride();
+    const int max_iterations = 2 * (rows * cols);
+
+    // Flat packed arrays; the padded border stays at INF_KEY like a wall.
+    std::vector<std::uint64_t> value(grid.getCellCount(), INF_KEY);
+    std::vector<std::uint64_t> step(grid.getCellCount(), INF_KEY);
+    for (int r = 0; r < rows; ++r) {
+        int idx = grid.toIndex(r, 0);
+        for (int c = 0; c < cols; ++c, ++idx) {
+            if (grid.isWalkableAt(idx) && !grid.isExitAt(idx)) step[idx] = key.pack(grid.getMoveCostAt(idx));
+        }
+    }
+    for (const auto& exit_pos : grid.getExitPositions()) {
+        value[grid.toIndex(exit_pos)] = 0;
+    }
+
+    const int thread_count = sweepThreadCount(rows, cols);
+    SweepBarrier barrier(thread_count);
+    // Double-buffered so the next sweep can count while this one is read.
+    std::atomic<size_t> improved_count[2] = {{0}, {0}};
+    int sweeps = 0;
+    size_t last_improved = 0;
+
+    auto worker = [&](int id) {
+        const int row_begin = rows * id / thread_count;
+        const int row_end = rows * (id + 1) / thread_count;
+        for (int sweep = 1; sweep <= max_iterations; ++sweep) {
+            size_t improved = relaxColour(value.data(), step.data(), stride, cols, row_begin, row_end, 0);
+            barrier.wait();
+            improved += relaxColour(value.data(), step.data(), stride, cols, row_begin, row_end, 1);
+            improved_count[sweep & 1] += improved;
+            barrier.wait();
+            size_t total = improved_count[sweep & 1];
+            if (id == 0) {
+                improved_count[(sweep + 1) & 1] = 0;
+                sweeps = sweep;
+                last_improved = total;
+            }
+            if (total == 0) break;
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < thread_count; ++id) helpers.emplace_back(worker, id);
+    worker(0);
+    for (auto& helper : helpers) helper.join();
+
+    iterations = sweeps;
+    residual = last_improved;
+    if (residual != 0) {
+        Logger::log(LogLevel::ERROR, "AVI safety break triggered after " + std::to_string(max_iterations) + " iterations. Possible infinite loop.");
+    }
+
+    cost_map.assign(grid.getCellCount(), Cost{});
+    for (int idx = 0; idx < grid.getCellCount(); ++idx) {
+        if (value[idx] != INF_KEY) cost_map[idx] = key.unpack(value[idx]);
+    }
+}
+
+// Fallback for grids whose path cost bound does not fit packed keys.
+template <typename Order>
+void AVI::iterate() {
+    cost_map.assign(grid.getCellCount(), Cost{});
 
     for (const auto& exit_pos : grid.getExitPositions()) {
-        cost_map[exit_pos.row][exit_pos.col] = {0, 0, 0};
+        cost_map[grid.toIndex(exit_pos)] = {0, 0, 0};
     }
 
-    bool changed = true;
-    int iteration = 0;
+    const auto& offsets = grid.getNeighborOffsets();
     int max_iterations = 2 * (grid.getRows() * grid.getCols());
+    iterations = 0;
+    residual = 1;
 
-    while (changed) {
-        changed = false;
-        iteration++;
-        if (iteration > max_iterations) {
+    while (residual != 0) {
+        if (iterations == max_iterations) {
             Logger::log(LogLevel::ERROR, "AVI safety break triggered after " + std::to_string(max_iterations) + " iterations. Possible infinite loop.");
             break;
         }
+        iterations++;
+        residual = 0;
 
         for (int r = 0; r < grid.getRows(); ++r) {
-            for (int c = 0; c < grid.getCols(); ++c) {
-                if (grid.isWalkable(r, c) && !grid.isExit(r, c)) {
+            int idx = grid.toIndex(r, 0);
+            for (int c = 0; c < grid.getCols(); ++c, ++idx) {
+                if (grid.isWalkableAt(idx) && !grid.isExitAt(idx)) {
+                    // THE FIX: The cost of an action (moving from r,c to neighbor)
+                    // is the cost incurred for taking a step FROM {r,c}.
+                    Cost move_cost = grid.getMoveCostAt(idx);
                     Cost min_cost;
-                    
-                    int dr[] = {-1, 1, 0, 0};
-                    int dc[] = {0, 0, -1, 1};
-
-                    for (int i = 0; i < 4; ++i) {
-                        Position neighbor = {r + dr[i], c + dc[i]};
-                        if (grid.isValid(neighbor.row, neighbor.col)) {
-                            Cost neighbor_cost = cost_map[neighbor.row][neighbor.col];
-                            // THE FIX: The cost of an action (moving from r,c to neighbor)
-                            // is the cost incurred for taking a step FROM {r,c}.
-                            Cost move_cost = grid.getMoveCost({r,c});
-                            min_cost = std::min(min_cost, neighbor_cost + move_cost);
-                        }
+
+                    // Padding cells keep the default cost, so they never win the min.
+                    for (int offset : offsets) {
+                        Cost candidate = cost_map[idx + offset] + move_cost;
+                        if (Order::less(candidate, min_cost)) min_cost = candidate;
                     }
 
-                    if (min_cost < cost_map[r][c]) {
-                        cost_map[r][c] = min_cost;
-                        changed = true;
+                    if (Order::less(min_cost, cost_map[idx])) {
+                        cost_map[idx] = min_cost;
+                        residual++;
                     }
                 }
             }
@@ -61,13 +199,14 @@ void AVI::run() {
 Cost AVI::getEvacuationCost() const {
     auto start_pos = grid.getStartPosition();
     if (grid.isValid(start_pos.row, start_pos.col)) {
-        return cost_map[start_pos.row][start_pos.col];
+        return cost_map[grid.toIndex(start_pos)];
     }
     return {};
 }
 
 void AVI::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Final Cost Map (Value Iteration)</h2>\n";
+    report_file << "<p><strong>Sweeps:</strong> " << iterations << " &nbsp; <strong>Residual:</strong> " << residual << " cells updated in the last sweep</p>\n";
     report_file << grid.toHtmlStringWithCost(cost_map);
 }
 
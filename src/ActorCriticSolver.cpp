@@ -1,72 +1,119 @@
 #include "enmod/ActorCriticSolver.h"
+#include "enmod/PolicyEvaluator.h"
 #include <random>
-#include <chrono>
 #include <algorithm>
 #include <vector>
 #include <numeric>
+#include <utility>
 
-ActorCriticSolver::ActorCriticSolver(const Grid& grid_ref) : RLSolver(grid_ref, "ActorCritic") {}
+namespace {
+// Warm-started actors pick the seeded best action with probability 4/7.
+constexpr float SEEDED_PREFERENCE = 4.0f;
+}
+
+// The actor's preferences start equal, at 1; critic values start at 0.
+ActorCriticSolver::ActorCriticSolver(const Grid& grid_ref)
+    : RLSolver(grid_ref, "ActorCritic", 1.0f), state_value_table(grid_ref.getCellCount()) {}
 
 void ActorCriticSolver::run() {
-    train(10000); // Actor-Critic can take longer to converge
+    pretrain(10000); // Actor-Critic can take longer to converge
     generatePolicyFromValueTable();
 }
 
-Direction ActorCriticSolver::chooseAction(const Position& state) {
-    static std::mt19937 rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
-    
-    if (value_table.find(state) == value_table.end()) {
-        value_table[state] = {1.0, 1.0, 1.0, 1.0}; // Equal probabilities initially
+Direction ActorCriticSolver::sampleAction(int state, std::mt19937& rng) {
+    value_table.touch(state);
+
+    // Choose action based on the probabilities in the actor's table.
+    // Sampled by hand: a std::discrete_distribution allocates on every call.
+    float preferences[ValueTable::ACTIONS];
+    double total = 0.0;
+    for (int i = 0; i < ValueTable::ACTIONS; ++i) {
+        preferences[i] = value_table.get(state, i);
+        total += preferences[i];
     }
-    
-    // Choose action based on the probabilities in the actor's table
-    std::discrete_distribution<> dist(value_table.at(state).begin(), value_table.at(state).end());
-    return static_cast<Direction>(dist(rng));
+    double pick = std::uniform_real_distribution<>(0.0, total)(rng);
+    for (int i = 0; i < ValueTable::ACTIONS - 1; ++i) {
+        pick -= preferences[i];
+        if (pick < 0) return static_cast<Direction>(i);
+    }
+    return static_cast<Direction>(ValueTable::ACTIONS - 1);
 }
 
-void ActorCriticSolver::update(const Position& s, Direction a, double r, const Position& s_next, Direction /*a_next*/) {
+void ActorCriticSolver::update(int s, Direction a, double r, int s_next, Direction /*a_next*/) {
     double actor_alpha = 0.01; // Actor often needs a smaller learning rate
 
     // --- Critic Update ---
-    double old_state_value = state_value_table.count(s) ? state_value_table[s] : 0.0;
-    double next_state_value = state_value_table.count(s_next) ? state_value_table[s_next] : 0.0;
-    
+    double old_state_value = state_value_table[s].load(std::memory_order_relaxed);
+    double next_state_value = state_value_table[s_next].load(std::memory_order_relaxed);
+
     // Calculate the TD Error
     double td_error = r + gamma * next_state_value - old_state_value;
-    
+
     // Update the Critic's value for the current state
-    state_value_table[s] = old_state_value + alpha * td_error;
+    state_value_table[s].store(static_cast<float>(old_state_value + alpha * td_error), std::memory_order_relaxed);
 
     // --- Actor Update ---
-    if (value_table.find(s) == value_table.end()) {
-        value_table[s] = {1.0, 1.0, 1.0, 1.0};
-    }
     // Update the probability of taking that action based on the Critic's feedback (TD Error)
+    value_table.touch(s);
     int action_idx = static_cast<int>(a);
-    value_table[s][action_idx] += actor_alpha * td_error;
+    float preference = value_table.get(s, action_idx) + static_cast<float>(actor_alpha * td_error);
     // Ensure probabilities don't go below a small value
-    if(value_table[s][action_idx] < 0.01) value_table[s][action_idx] = 0.01;
+    value_table.set(s, action_idx, std::max(preference, 0.01f));
 }
 
-Cost ActorCriticSolver::getEvacuationCost() const {
-    Position current = grid.getStartPosition();
-    Cost total_cost = {0, 0, 0};
-    std::vector<Position> path;
-    for (int i = 0; i < grid.getRows() * grid.getCols() + 1; ++i) {
-        path.push_back(current);
-        if (grid.isExit(current.row, current.col)) return total_cost;
-        Direction dir = policy.getDirection(current);
-        if (dir == Direction::NONE) return {};
-        total_cost = total_cost + grid.getMoveCost(current);
-        current = grid.getNextPosition(current, dir);
-        if(std::find(path.begin(), path.end(), current) != path.end()) return {};
+void ActorCriticSolver::seedValues(const std::vector<double>& state_values) {
+    for (int r = 0; r < grid.getRows(); ++r) {
+        int idx = grid.toIndex(r, 0);
+        for (int c = 0; c < grid.getCols(); ++c, ++idx) {
+            if (!grid.isWalkableAt(idx)) continue;
+            state_value_table[idx].store(static_cast<float>(state_values[idx]), std::memory_order_relaxed);
+
+            int best = 0;
+            double best_value = 0;
+            for (int a = 0; a < ValueTable::ACTIONS; ++a) {
+                double value = mdp.reward(idx, a) + gamma * state_values[mdp.next(idx, a)];
+                if (a == 0 || value > best_value) {
+                    best = a;
+                    best_value = value;
+                }
+            }
+            value_table.touch(idx);
+            for (int a = 0; a < ValueTable::ACTIONS; ++a) {
+                value_table.set(idx, a, a == best ? SEEDED_PREFERENCE : 1.0f);
+            }
+        }
     }
-    return {};
+}
+
+ModelLayout ActorCriticSolver::modelLayout() const {
+    ModelLayout layout = RLSolver::modelLayout();
+    layout.floats.push_back(state_value_table.size());
+    return layout;
+}
+
+void ActorCriticSolver::saveModel(ModelData& model) const {
+    RLSolver::saveModel(model);
+    std::vector<float> critic(state_value_table.size());
+    for (size_t idx = 0; idx < critic.size(); ++idx) critic[idx] = state_value_table[idx].load(std::memory_order_relaxed);
+    model.floats.push_back(std::move(critic));
+}
+
+void ActorCriticSolver::restoreModel(const ModelData& model) {
+    RLSolver::restoreModel(model);
+    for (size_t idx = 0; idx < state_value_table.size(); ++idx) {
+        state_value_table[idx].store(model.floats[1][idx], std::memory_order_relaxed);
+    }
+}
+
+Cost ActorCriticSolver::getEvacuationCost() const {
+    PolicyEvaluator evaluator(grid);
+    evaluator.evaluate(policy);
+    return evaluator.getValue(grid.getStartPosition());
 }
 
 void ActorCriticSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Final Learned Policy (Actor-Critic)</h2>\n";
-    report_file << "<p>This policy was learned over 10000 episodes.</p>\n";
+    writeTrainingSummary(report_file);
     report_file << grid.toHtmlStringWithPolicy(policy);
 }
 
@@ -1,5 +1,6 @@
 #include "enmod/AdaptiveCostSolver.h"
-#include "enmod/BIDP.h"
+#include "enmod/EnvironmentAssessment.h"
+#include "enmod/IncrementalBIDP.h"
 #include "enmod/Logger.h"
 #include <algorithm>
 #include <cmath>
@@ -7,64 +8,32 @@
 AdaptiveCostSolver::AdaptiveCostSolver(const Grid& grid_ref) 
     : Solver(grid_ref, "AdaptiveCostSim"), current_mode(EvacuationMode::NORMAL) {}
 
-void AdaptiveCostSolver::assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid) {
-    const auto& events = current_grid.getConfig().value("dynamic_events", json::array());
-    current_mode = EvacuationMode::NORMAL; 
-
-    for (const auto& event : events) {
-        if (event.value("type", "") == "fire") {
-            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
-            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
-                int radius = 1;
-                if(event.value("size", "small") == "medium") radius = 2;
-                if(event.value("size", "small") == "large") radius = 3;
-
-                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
-                if (dist <= 1) { current_mode = EvacuationMode::PANIC; return; }
-                if (dist <= radius) { current_mode = EvacuationMode::ALERT; }
-            }
-        }
-    }
-
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
-    for(int i = 0; i < 4; ++i) {
-        Position neighbor = {current_pos.row + dr[i], current_pos.col + dc[i]};
-        if(current_grid.getSmokeIntensity(neighbor) == "heavy"){
-             if (current_mode != EvacuationMode::PANIC) current_mode = EvacuationMode::ALERT;
-        }
-    }
-}
-
 void AdaptiveCostSolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
+    // Keeps its cost map across ticks and only repairs what the events changed.
+    IncrementalBIDP planner(dynamic_grid);
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) {
-                dynamic_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
-        assessThreatAndSetMode(current_pos, dynamic_grid);
-        Cost::current_mode = current_mode;
-        history.push_back({t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode});
+        current_mode = assessThreatAndSetMode(current_pos, dynamic_grid);
+        history.record(t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode);
 
         if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
             history.back().action = "SUCCESS: Reached Exit.";
             break;
         }
 
-        BIDP step_planner(dynamic_grid);
-        step_planner.run();
-        const auto& cost_map = step_planner.getCostMap();
+        planner.update(current_mode);
+        const auto& cost_map = planner.getCostMap();
         
-        Cost best_neighbor_cost = cost_map[current_pos.row][current_pos.col];
+        Cost best_neighbor_cost = cost_map[dynamic_grid.toIndex(current_pos)];
         Position best_next_move = current_pos;
         std::string action = "STAY";
         
@@ -75,15 +44,15 @@ void AdaptiveCostSolver::run() {
         for (int i = 0; i < 4; ++i) {
             Position neighbor = {current_pos.row + dr[i], current_pos.col + dc[i]};
             if (dynamic_grid.isWalkable(neighbor.row, neighbor.col)) {
-                if (cost_map[neighbor.row][neighbor.col] < best_neighbor_cost) {
-                    best_neighbor_cost = cost_map[neighbor.row][neighbor.col];
+                if (costLess(current_mode, cost_map[dynamic_grid.toIndex(neighbor)], best_neighbor_cost)) {
+                    best_neighbor_cost = cost_map[dynamic_grid.toIndex(neighbor)];
                     best_next_move = neighbor;
                     action = actions[i];
                 }
             }
         }
         
-        if(best_next_move == current_pos && cost_map[current_pos.row][current_pos.col].distance == MAX_COST){
+        if(best_next_move == current_pos && cost_map[dynamic_grid.toIndex(current_pos)].distance == MAX_COST){
             history.back().action = "FAILURE: No path found.";
             total_cost = {};
             break;
@@ -94,17 +63,16 @@ void AdaptiveCostSolver::run() {
         current_pos = best_next_move;
     }
      if(history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)){
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
          total_cost = {};
      }
-     Cost::current_mode = EvacuationMode::NORMAL;
 }
 
 Cost AdaptiveCostSolver::getEvacuationCost() const { return total_cost; }
 
 void AdaptiveCostSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (Adaptive Cost Solver)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         std::string mode_str;
         switch(step.mode){
             case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
@@ -115,6 +83,6 @@ void AdaptiveCostSolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "enmod/AnytimeDStar.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+constexpr double INF = std::numeric_limits<double>::infinity();
+}
+
+AnytimeDStar::AnytimeDStar(const Grid& grid_ref, double initial_epsilon, double epsilon_step)
+    : grid(grid_ref), initial_epsilon(std::max(1.0, initial_epsilon)), epsilon_step(epsilon_step) {
+    // Allocate and seed here so the first tick's budget goes to searching.
+    search = &states[0];
+    reset();
+}
+
+double AnytimeDStar::stepCost(int idx) const {
+    const Cost& cost = grid.getMoveCostAt(idx);
+    const double* weight = search->weight;
+    return weight[0] * cost.smoke + weight[1] * cost.time + weight[2] * cost.distance;
+}
+
+// Steps between the cell and the agent, each at the cheapest step cost.
+double AnytimeDStar::heuristic(int idx) const {
+    Position pos = grid.toPosition(idx);
+    return search->min_step * (std::abs(pos.row - start_pos.row) + std::abs(pos.col - start_pos.col));
+}
+
+// The agent can still step off a cell that a hazard made unwalkable.
+bool AnytimeDStar::isOccupiable(int idx) const {
+    return grid.isWalkableAt(idx) || idx == search->start_idx;
+}
+
+AnytimeDStar::Key AnytimeDStar::key(int idx) const {
+    const double g = search->g[idx];
+    const double rhs = search->rhs[idx];
+    if (g > rhs) return {rhs + search->epsilon * heuristic(idx), rhs};
+    return {g + heuristic(idx), g};
+}
+
+void AnytimeDStar::reset() {
+    SearchState& state = *search;
+    state.initialized = true;
+    // Least significant field weighs 1; each more significant field weighs
+    // more than the largest possible path total of everything below it.
+    const CostBound& bound = grid.getPathCostBound();
+    const long long totals[3] = {bound.smoke, bound.time, bound.distance};
+    withCostOrder(order, [&](auto ordering) {
+        const int (&fields)[3] = decltype(ordering)::fields;
+        double scale = 1;
+        for (int i = 2; i >= 0; --i) {
+            state.weight[fields[i]] = scale;
+            scale *= static_cast<double>(totals[fields[i]]) + 1;
+        }
+    });
+    // Every move costs at least one time unit and one distance unit.
+    state.min_step = state.weight[1] + state.weight[2];
+
+    const int cells = grid.getCellCount();
+    state.g.assign(cells, INF);
+    state.rhs.assign(cells, INF);
+    state.closed.assign(cells, 0);
+    state.closed_generation = 1;
+    state.in_incons.assign(cells, 0);
+    state.incons.clear();
+    state.open_set.reset(cells);
+    state.epsilon = initial_epsilon;
+    state.start_idx = -1;
+    state.changes_seen = grid.getChangedCells().size();
+
+    for (const auto& exit_pos : grid.getExitPositions()) {
+        int idx = grid.toIndex(exit_pos);
+        if (grid.isExitAt(idx)) updateState(idx);
+    }
+}
+
+void AnytimeDStar::updateState(int idx) {
+    SearchState& state = *search;
+    if (!isOccupiable(idx)) {
+        state.rhs[idx] = INF;
+    } else if (grid.isExitAt(idx)) {
+        // Free edge to the virtual goal.
+        state.rhs[idx] = 0;
+    } else {
+        double best = INF;
+        for (int offset : grid.getNeighborOffsets()) {
+            int next = idx + offset;
+            if (grid.isWalkableAt(next)) best = std::min(best, stepCost(next) + state.g[next]);
+        }
+        state.rhs[idx] = best;
+    }
+
+    state.open_set.remove(idx);
+    if (state.g[idx] == state.rhs[idx]) return;
+    if (state.closed[idx] != state.closed_generation) {
+        state.open_set.push(idx, key(idx));
+    } else if (!state.in_incons[idx]) {
+        state.in_incons[idx] = 1;
+        state.incons.push_back(idx);
+    }
+}
+
+// A changed cell alters its own walkability and the cost of every edge into it.
+bool AnytimeDStar::applyChanges() {
+    SearchState& state = *search;
+    const auto& changes = grid.getChangedCells();
+    if (state.changes_seen == changes.size()) return false;
+    for (; state.changes_seen < changes.size(); ++state.changes_seen) {
+        int idx = changes[state.changes_seen];
+        updateState(idx);
+        for (int offset : grid.getNeighborOffsets()) {
+            if (isOccupiable(idx + offset)) updateState(idx + offset);
+        }
+    }
+    // Repair with a loose bound first, then tighten it again.
+    state.epsilon = initial_epsilon;
+    return true;
+}
+
+void AnytimeDStar::beginIteration() {
+    SearchState& state = *search;
+    for (int idx : state.incons) {
+        state.in_incons[idx] = 0;
+        if (state.g[idx] != state.rhs[idx]) state.open_set.push(idx, key(idx));
+    }
+    state.incons.clear();
+    state.open_set.rekey([this](int idx) { return key(idx); });
+    ++state.closed_generation;
+}
+
+bool AnytimeDStar::computeOrImprovePath(size_t expansion_limit) {
+    SearchState& state = *search;
+    const auto& offsets = grid.getNeighborOffsets();
+    const int start_idx = state.start_idx;
+    auto& g = state.g;
+    auto& rhs = state.rhs;
+    while (!state.open_set.empty() && (state.open_set.topKey() < key(start_idx) || rhs[start_idx] != g[start_idx])) {
+        if (expansions >= expansion_limit) return false;
+        ++expansions;
+        int idx = state.open_set.topId();
+        state.open_set.pop();
+
+        if (g[idx] > rhs[idx]) {
+            g[idx] = rhs[idx];
+            state.closed[idx] = state.closed_generation;
+        } else {
+            g[idx] = INF;
+            updateState(idx);
+        }
+        for (int offset : offsets) {
+            if (isOccupiable(idx + offset)) updateState(idx + offset);
+        }
+    }
+    return true;
+}
+
+double AnytimeDStar::pathCost(const std::vector<Position>& path, size_t first) const {
+    if (first >= path.size() || !grid.isExit(path.back().row, path.back().col)) return INF;
+    double total = 0;
+    for (size_t i = first + 1; i < path.size(); ++i) {
+        if (!grid.isWalkable(path[i].row, path[i].col)) return INF;
+        total += stepCost(grid.toIndex(path[i]));
+    }
+    return total;
+}
+
+// Greedy descent on g from the agent. Leaves the path empty if it hits a
+// dead end or runs longer than the grid, as an interrupted search can.
+void AnytimeDStar::extractPath() {
+    path.clear();
+    const auto& g = search->g;
+    const int start_idx = search->start_idx;
+    if (g[start_idx] == INF) return;
+    const auto& offsets = grid.getNeighborOffsets();
+    int idx = start_idx;
+    path.push_back(start_pos);
+    while (!grid.isExitAt(idx)) {
+        if (path.size() > static_cast<size_t>(grid.getRows()) * grid.getCols()) {
+            path.clear();
+            return;
+        }
+        int best = -1;
+        double best_cost = INF;
+        for (int offset : offsets) {
+            int next = idx + offset;
+            if (!grid.isWalkableAt(next)) continue;
+            double cost = stepCost(next) + g[next];
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = next;
+            }
+        }
+        if (best < 0) {
+            path.clear();
+            return;
+        }
+        idx = best;
+        path.push_back(grid.toPosition(idx));
+    }
+}
+
+void AnytimeDStar::plan(const Position& start, EvacuationMode mode, size_t expansion_budget) {
+    const size_t expansion_limit = expansions + expansion_budget;
+    EvacuationMode new_order = costOrderMode(mode);
+    const bool switched = new_order != order;
+    if (switched) {
+        order = new_order;
+        search = &states[order == EvacuationMode::NORMAL ? 0 : 1];
+    }
+    const bool restart = !search->initialized;
+    if (restart) reset();
+
+    SearchState& state = *search;
+    const int previous_start = state.start_idx;
+    start_pos = start;
+    state.start_idx = grid.toIndex(start);
+    unreachable = false;
+
+    const bool changed = !restart && applyChanges();
+    if (previous_start != state.start_idx) {
+        if (previous_start >= 0 && !isOccupiable(previous_start)) updateState(previous_start);
+        if (!grid.isWalkableAt(state.start_idx)) updateState(state.start_idx);
+    }
+    // A bounded path from the last call still holds if nothing moved.
+    bool has_bounded_path = !switched && !changed && previous_start == state.start_idx && path_epsilon > 0;
+
+    while (true) {
+        beginIteration();
+        if (!computeOrImprovePath(expansion_limit)) {
+            // Out of budget before this bound was met. Keep the last bounded
+            // path for this start; without one, a descent on the partial
+            // values is still a walkable route if it reaches an exit.
+            if (!has_bounded_path) {
+                extractPath();
+                path_epsilon = 0;
+            }
+            return;
+        }
+        extractPath();
+        path_epsilon = state.epsilon;
+        has_bounded_path = true;
+        if (state.g[state.start_idx] == INF) {
+            unreachable = true;
+            return;
+        }
+        if (state.epsilon <= 1.0 || expansions >= expansion_limit) return;
+        state.epsilon = std::max(1.0, state.epsilon - epsilon_step);
+    }
+}
@@ -1,44 +1,50 @@
 #include "enmod/BIDP.h"
 #include "enmod/HtmlReportGenerator.h"
-#include <queue>
+#include "enmod/CostQueue.h"
 #include <vector>
 #include <algorithm>
 
-BIDP::BIDP(const Grid& grid_ref) : Solver(grid_ref, "BIDP") {}
+BIDP::BIDP(const Grid& grid_ref, EvacuationMode mode) : Solver(grid_ref, "BIDP"), mode(mode) {}
 
 void BIDP::run() {
-    cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
+    withCostOrder(mode, [this](auto order) { search<decltype(order)>(); });
+}
+
+template <typename Order>
+void BIDP::search() {
+    cost_map.assign(grid.getCellCount(), Cost{});
 
-    std::priority_queue<std::pair<Cost, Position>, std::vector<std::pair<Cost, Position>>, std::greater<std::pair<Cost, Position>>> pq;
+    // The ordering is fixed for the whole search, so the queue can use packed integer keys.
+    CostQueue<Order> pq(grid);
 
     for (const auto& exit_pos : grid.getExitPositions()) {
-        cost_map[exit_pos.row][exit_pos.col] = {0, 0, 0};
-        pq.push({{0, 0, 0}, exit_pos});
+        int exit_idx = grid.toIndex(exit_pos);
+        cost_map[exit_idx] = {0, 0, 0};
+        pq.push({0, 0, 0}, exit_idx);
     }
 
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
+    const auto& offsets = grid.getNeighborOffsets();
 
     while (!pq.empty()) {
-        auto [current_cost, current_pos] = pq.top();
-        pq.pop();
+        auto [current_cost, current_idx] = pq.pop();
 
-        if (cost_map[current_pos.row][current_pos.col] < current_cost) {
+        if (Order::less(cost_map[current_idx], current_cost)) {
             continue;
         }
 
-        for (int i = 0; i < 4; ++i) {
-            Position next_pos = {current_pos.row + dr[i], current_pos.col + dc[i]};
+        for (int offset : offsets) {
+            int next_idx = current_idx + offset;
 
-            if (grid.isWalkable(next_pos.row, next_pos.col)) {
+            // The padded border is WALL, so no bounds check is needed here.
+            if (grid.isWalkableAt(next_idx)) {
                 // THE FIX: In a backward search, the cost of a move is associated with the cell
                 // you are coming FROM, which is the 'next_pos' in this context.
-                Cost move_cost = grid.getMoveCost(next_pos); 
+                Cost move_cost = grid.getMoveCostAt(next_idx);
                 Cost new_cost = current_cost + move_cost;
 
-                if (new_cost < cost_map[next_pos.row][next_pos.col]) {
-                    cost_map[next_pos.row][next_pos.col] = new_cost;
-                    pq.push({new_cost, next_pos});
+                if (Order::less(new_cost, cost_map[next_idx])) {
+                    cost_map[next_idx] = new_cost;
+                    pq.push(new_cost, next_idx);
                 }
             }
         }
@@ -48,7 +54,7 @@ void BIDP::run() {
 Cost BIDP::getEvacuationCost() const {
     auto start_pos = grid.getStartPosition();
     if (grid.isValid(start_pos.row, start_pos.col)) {
-        return cost_map[start_pos.row][start_pos.col];
+        return cost_map[grid.toIndex(start_pos)];
     }
     return {};
 }
@@ -58,7 +64,7 @@ void BIDP::generateReport(std::ofstream& report_file) const {
     report_file << grid.toHtmlStringWithCost(cost_map);
 }
 
-const std::vector<std::vector<Cost>>& BIDP::getCostMap() const {
+const std::vector<Cost>& BIDP::getCostMap() const {
     return cost_map;
 }
 
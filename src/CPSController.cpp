@@ -40,6 +40,7 @@ Direction CPSController::read_output_file() {
 
 void CPSController::run_simulation() {
     std::cout << "\n===== Starting Real-Time CPS Simulation =====\n";
+    EventTimeline::Cursor events = master_grid.getEventTimeline().cursor();
     
     for (int t = 0; t < 2 * (master_grid.getRows() * master_grid.getCols()); ++t) {
         // 1. Simulate agent sending data to server
@@ -81,10 +82,8 @@ void CPSController::run_simulation() {
         std::cout << "Timestep " << t << ": Agent at (" << agent_position.row << ", " << agent_position.col << ") received command: " << move_str << std::endl;
 
         // Update the master grid with any dynamic events for the next timestep
-        for (const auto& event_cfg : master_grid.getConfig().value("dynamic_events", json::array())) {
-            if (event_cfg.value("time_step", -1) == t + 1) {
-                master_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t + 1)) {
+            master_grid.applyEvent(event);
         }
         
         if (master_grid.isExit(agent_position.row, agent_position.col)) {
@@ -1,23 +1,14 @@
 #include "enmod/Cost.h"
 
-bool Cost::operator<(const Cost& other) const {
-    switch (current_mode) {
-        case EvacuationMode::PANIC:
-        case EvacuationMode::ALERT:
-            if (smoke != other.smoke) return smoke < other.smoke;
-            if (time != other.time) return time < other.time;
-            return distance < other.distance;
-        case EvacuationMode::NORMAL:
-        default:
-            if (time != other.time) return time < other.time;
-            if (distance != other.distance) return distance < other.distance;
-            return smoke < other.smoke;
-    }
-}
-
+bool Cost::operator<(const Cost& other) const { return LexTimeFirst::less(*this, other); }
 bool Cost::operator>(const Cost& other) const { return other < *this; }
 bool Cost::operator==(const Cost& other) const { return smoke == other.smoke && time == other.time && distance == other.distance; }
 
+bool costLess(EvacuationMode mode, const Cost& a, const Cost& b) {
+    if (mode == EvacuationMode::NORMAL) return LexTimeFirst::less(a, b);
+    return LexSmokeFirst::less(a, b);
+}
+
 Cost Cost::operator+(const Cost& other) const {
     if (distance == MAX_COST || other.distance == MAX_COST) return {};
     return {smoke + other.smoke, time + other.time, distance + other.distance};
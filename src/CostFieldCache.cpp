@@ -0,0 +1,75 @@
+#include "enmod/CostFieldCache.h"
+
+CostFieldCache::CostFieldCache(size_t max_cells) : max_cells(max_cells) {}
+
+CostFieldCache& CostFieldCache::shared() {
+    static CostFieldCache cache;
+    return cache;
+}
+
+CostFieldCache::Field CostFieldCache::find(const CostFieldKey& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+void CostFieldCache::insert(const CostFieldKey& key, Field field) {
+    if (!field) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Another solver stored the same field first; keep theirs.
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    cached_cells += field->size();
+    entries.emplace_front(key, std::move(field));
+    index[key] = entries.begin();
+    evictOverBudget();
+}
+
+void CostFieldCache::evictOverBudget() {
+    // Always keep the newest entry, even if it alone exceeds the budget.
+    while (cached_cells > max_cells && entries.size() > 1) {
+        const Entry& oldest = entries.back();
+        cached_cells -= oldest.second->size();
+        index.erase(oldest.first);
+        entries.pop_back();
+    }
+}
+
+void CostFieldCache::setMaxCells(size_t cells) {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_cells = cells;
+    evictOverBudget();
+}
+
+void CostFieldCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    cached_cells = 0;
+    hits = 0;
+    misses = 0;
+}
+
+size_t CostFieldCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t CostFieldCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t CostFieldCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
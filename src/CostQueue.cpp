@@ -0,0 +1,38 @@
+#include "enmod/CostQueue.h"
+
+namespace {
+int bitWidth(long long value) {
+    int bits = 1;
+    while (bits < 63 && (value >> bits) != 0) ++bits;
+    return bits;
+}
+}
+
+CostKey::CostKey(const Grid& grid, const int (&fields)[3]) {
+    const CostBound& bound = grid.getPathCostBound();
+    const long long totals[3] = {bound.smoke, bound.time, bound.distance};
+
+    // Least significant field goes in the low bits.
+    int used = 0;
+    for (int i = 2; i >= 0; --i) {
+        int field = fields[i];
+        int width = bitWidth(totals[field]);
+        shift[field] = used;
+        mask[field] = (width >= 64) ? ~0ULL : ((1ULL << width) - 1);
+        used += width;
+    }
+    used_bits = used;
+    fits_64 = used <= 64;
+}
+
+std::uint64_t CostKey::pack(const Cost& cost) const {
+    return (static_cast<std::uint64_t>(cost.smoke) << shift[0]) |
+           (static_cast<std::uint64_t>(cost.time) << shift[1]) |
+           (static_cast<std::uint64_t>(cost.distance) << shift[2]);
+}
+
+Cost CostKey::unpack(std::uint64_t key) const {
+    return {static_cast<int>((key >> shift[0]) & mask[0]),
+            static_cast<int>((key >> shift[1]) & mask[1]),
+            static_cast<int>((key >> shift[2]) & mask[2])};
+}
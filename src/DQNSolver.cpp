@@ -1,5 +1,7 @@
 #include "enmod/DQNSolver.h"
+#include "enmod/EnvironmentAssessment.h"
 #include "enmod/Logger.h"
+#include "enmod/ModelCache.h"
 #include <random>
 #include <chrono>
 #include <algorithm>
@@ -95,6 +97,29 @@ void NeuralNetwork::train(const std::vector<double>& input, const std::vector<do
     }
 }
 
+size_t NeuralNetwork::weightCount() const {
+    return static_cast<size_t>(hidden_size) * (input_size + 1) + static_cast<size_t>(output_size) * (hidden_size + 1);
+}
+
+std::vector<float> NeuralNetwork::exportWeights() const {
+    std::vector<float> flat;
+    flat.reserve(weightCount());
+    for (const auto& row : weights1) flat.insert(flat.end(), row.begin(), row.end());
+    flat.insert(flat.end(), bias1.begin(), bias1.end());
+    for (const auto& row : weights2) flat.insert(flat.end(), row.begin(), row.end());
+    flat.insert(flat.end(), bias2.begin(), bias2.end());
+    return flat;
+}
+
+bool NeuralNetwork::importWeights(const std::vector<float>& flat) {
+    if (flat.size() != weightCount()) return false;
+    size_t i = 0;
+    for (auto& row : weights1) for (auto& val : row) val = flat[i++];
+    for (auto& val : bias1) val = flat[i++];
+    for (auto& row : weights2) for (auto& val : row) val = flat[i++];
+    for (auto& val : bias2) val = flat[i++];
+    return true;
+}
 
 // --- ReplayBuffer Implementation ---
 ReplayBuffer::ReplayBuffer(size_t cap) : capacity(cap) {}
@@ -124,8 +149,16 @@ DQNSolver::DQNSolver(const Grid& grid_ref)
       target_net(5 * 5, 24, 4),
       replay_buffer(10000)
 {
+    model_key = ModelFingerprint(grid_ref).add(gamma).add(epsilon_decay)
+        .add(std::uint64_t(5 * 5)).add(std::uint64_t(24)).add(std::uint64_t(4)).value();
+    ModelData model;
+    ModelLayout layout{{policy_net.weightCount()}, {}};
+    if (ModelCache::shared().load(solver_name, model_key, layout, model)) {
+        loaded_from_cache = policy_net.importWeights(model.floats[0]);
+    }
     target_net = policy_net; // Initialize target network with policy network weights
-    Logger::log(LogLevel::INFO, "DQN Solver initialized with a neural network.");
+    Logger::log(LogLevel::INFO, loaded_from_cache ? "DQN Solver initialized from cached weights."
+                                                  : "DQN Solver initialized with a neural network.");
 }
 
 std::vector<double> DQNSolver::getStateRepresentation(const Grid& current_grid, const Position& pos) {
@@ -196,40 +229,20 @@ void DQNSolver::replay() {
     }
 }
 
-void DQNSolver::assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid) {
-    const auto& events = current_grid.getConfig().value("dynamic_events", json::array());
-    current_mode = EvacuationMode::NORMAL;
-    for (const auto& event : events) {
-        if (event.value("type", "") == "fire") {
-            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
-            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
-                 int radius = 1;
-                if(event.value("size", "small") == "medium") radius = 2;
-                if(event.value("size", "small") == "large") radius = 3;
-                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
-                if (dist <= 1) { current_mode = EvacuationMode::PANIC; return; }
-                if (dist <= radius) { current_mode = EvacuationMode::ALERT; }
-            }
-        }
-    }
-}
-
 void DQNSolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) dynamic_grid.addHazard(event_cfg);
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
 
-        assessThreatAndSetMode(current_pos, dynamic_grid);
-        Cost::current_mode = current_mode;
+        current_mode = assessThreatAndSetMode(current_pos, dynamic_grid);
         
         std::vector<double> state_repr = getStateRepresentation(dynamic_grid, current_pos);
         Direction move_dir = chooseAction(state_repr, dynamic_grid, current_pos);
@@ -255,7 +268,7 @@ void DQNSolver::run() {
         else if (move_dir == Direction::DOWN) action_str = "DOWN";
         else if (move_dir == Direction::LEFT) action_str = "LEFT";
         else if (move_dir == Direction::RIGHT) action_str = "RIGHT";
-        history.push_back({t, dynamic_grid, current_pos, action_str, total_cost, current_mode});
+        history.record(t, dynamic_grid, current_pos, action_str, total_cost, current_mode);
 
         total_cost = total_cost + dynamic_grid.getMoveCost(current_pos);
         current_pos = next_pos;
@@ -263,22 +276,31 @@ void DQNSolver::run() {
         replay();
         
         if (done) {
-            history.push_back({t + 1, dynamic_grid, current_pos, "SUCCESS: Reached Exit.", total_cost, current_mode});
+            history.record(t + 1, dynamic_grid, current_pos, "SUCCESS: Reached Exit.", total_cost, current_mode);
             break;
         }
     }
 
     if(history.empty() || history.back().action.find("SUCCESS") == std::string::npos) {
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
          total_cost = {};
     }
+
+    // Only the first run's network is kept. Later runs start from the same
+    // weights instead of training on top of every run before them.
+    if (!loaded_from_cache) {
+        ModelData model;
+        model.floats.push_back(policy_net.exportWeights());
+        ModelCache::shared().store(solver_name, model_key, model);
+    }
 }
 
 Cost DQNSolver::getEvacuationCost() const { return total_cost; }
 
 void DQNSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (DQN Solver)</h2>\n";
-    for (const auto& step : history) {
+    if (loaded_from_cache) report_file << "<p>The network started from weights cached by an earlier run.</p>\n";
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         std::string mode_str;
         switch(step.mode){
             case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
@@ -289,6 +311,6 @@ void DQNSolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
\ No newline at end of file
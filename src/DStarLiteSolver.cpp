@@ -4,7 +4,10 @@
 #include "enmod/Logger.h"
 #include <algorithm>
 #include <cmath>
-#include <map>
+
+namespace {
+constexpr double INF = std::numeric_limits<double>::infinity();
+}
 
 DStarLiteSolver::DStarLiteSolver(const Grid& grid_ref)
     : Solver(grid_ref, "DStarLiteSim"), dynamic_grid(grid_ref) {}
@@ -13,99 +16,84 @@ double DStarLiteSolver::heuristic(const Position& a, const Position& b) {
     return std::abs(a.row - b.row) + std::abs(a.col - b.col);
 }
 
-Key DStarLiteSolver::calculateKey(const Position& p) {
-    if (maze.find(p) == maze.end()) {
-        maze[p] = DStarNode();
-    }
-    double min_val = std::min(maze[p].g, maze[p].rhs);
-    return {min_val + heuristic(start_pos, p) + k_m, min_val};
+// Scalarised cost of entering the cell.
+double DStarLiteSolver::stepCost(int idx) const {
+    const Cost& move_cost = dynamic_grid.getMoveCostAt(idx);
+    return (move_cost.smoke * 1000) + (move_cost.time * 10) + (move_cost.distance * 1);
+}
+
+Key DStarLiteSolver::calculateKey(int idx) {
+    double min_val = std::min(g[idx], rhs[idx]);
+    return {min_val + heuristic(start_pos, dynamic_grid.toPosition(idx)) + k_m, min_val};
 }
 
 void DStarLiteSolver::initialize() {
-    maze.clear();
-    while (!open_set.empty()) open_set.pop();
+    g.assign(dynamic_grid.getCellCount(), INF);
+    rhs.assign(dynamic_grid.getCellCount(), INF);
+    open_set.reset(dynamic_grid.getCellCount());
+    changes_seen = dynamic_grid.getChangedCells().size();
     k_m = 0.0;
 
     start_pos = grid.getStartPosition();
-    if (!grid.getExitPositions().empty()) {
-        goal_pos = grid.getExitPositions()[0];
-    } else {
-        goal_pos = {-1, -1};
+    last_pos = start_pos;
+    // Every exit hangs off a virtual goal by a free edge, so exits start
+    // with rhs 0 and the search covers all of them at once.
+    for (const auto& exit_pos : grid.getExitPositions()) {
+        int idx = dynamic_grid.toIndex(exit_pos);
+        if (!dynamic_grid.isExitAt(idx)) continue;
+        rhs[idx] = 0;
+        open_set.push(idx, calculateKey(idx));
     }
-
-    maze[goal_pos].rhs = 0;
-    open_set.push({calculateKey(goal_pos), goal_pos});
 }
 
-void DStarLiteSolver::updateVertex(const Position& p) {
-    if (!(p == goal_pos)) {
-        double min_rhs = std::numeric_limits<double>::infinity();
-        int dr[] = {-1, 1, 0, 0};
-        int dc[] = {0, 0, -1, 1};
-
-        for (int i = 0; i < 4; ++i) {
-            Position successor = {p.row + dr[i], p.col + dc[i]};
-            if (dynamic_grid.isWalkable(successor.row, successor.col)) {
-                if (maze.find(successor) == maze.end()) maze[successor] = DStarNode();
-                Cost move_cost = dynamic_grid.getMoveCost(successor);
-                double cost_val = (move_cost.smoke * 1000) + (move_cost.time * 10) + (move_cost.distance * 1);
-                min_rhs = std::min(min_rhs, maze[successor].g + cost_val);
+void DStarLiteSolver::updateVertex(int idx) {
+    // An exit that stops being one (fire, blockage) loses its edge to the
+    // virtual goal and takes its rhs from its neighbours like any cell.
+    if (dynamic_grid.isExitAt(idx)) {
+        rhs[idx] = 0;
+    } else {
+        double min_rhs = INF;
+        // The padded border is WALL, so neighbours never leave the grid.
+        for (int offset : dynamic_grid.getNeighborOffsets()) {
+            int successor = idx + offset;
+            if (dynamic_grid.isWalkableAt(successor)) {
+                min_rhs = std::min(min_rhs, g[successor] + stepCost(successor));
             }
         }
-        maze[p].rhs = min_rhs;
-    }
-
-    // if p is in the open set, remove it
-    // (this is not efficient, but it is correct)
-    std::priority_queue<std::pair<Key, Position>, std::vector<std::pair<Key, Position>>, std::greater<std::pair<Key, Position>>> new_open_set;
-    while (!open_set.empty())
-    {
-        if (open_set.top().second.row != p.row || open_set.top().second.col != p.col)
-        {
-            new_open_set.push(open_set.top());
-        }
-        open_set.pop();
+        rhs[idx] = min_rhs;
     }
-    open_set = new_open_set;
 
-    if (maze[p].g != maze[p].rhs) {
-        open_set.push({calculateKey(p), p});
+    if (g[idx] != rhs[idx]) {
+        open_set.push(idx, calculateKey(idx));
+    } else {
+        open_set.remove(idx);
     }
 }
 
-
 void DStarLiteSolver::computeShortestPath() {
-    while (!open_set.empty() && (open_set.top().first < calculateKey(start_pos) || maze[start_pos].g != maze[start_pos].rhs)) {
-        Key k_old = open_set.top().first;
-        Position u = open_set.top().second;
-        open_set.pop();
+    const int start_idx = dynamic_grid.toIndex(start_pos);
+    const auto& offsets = dynamic_grid.getNeighborOffsets();
+    while (!open_set.empty() && (open_set.topKey() < calculateKey(start_idx) || g[start_idx] != rhs[start_idx])) {
+        Key k_old = open_set.topKey();
+        int u = open_set.topId();
 
         Key k_new = calculateKey(u);
         if (k_old < k_new) {
-            open_set.push({k_new, u});
+            open_set.push(u, k_new);
             continue;
         }
+        open_set.pop();
 
-        if (maze[u].g > maze[u].rhs) {
-            maze[u].g = maze[u].rhs;
-            int dr[] = {-1, 1, 0, 0};
-            int dc[] = {0, 0, -1, 1};
-            for (int i = 0; i < 4; ++i) {
-                Position predecessor = {u.row + dr[i], u.col + dc[i]};
-                if (dynamic_grid.isWalkable(predecessor.row, predecessor.col)) {
-                    updateVertex(predecessor);
-                }
-            }
+        if (g[u] > rhs[u]) {
+            g[u] = rhs[u];
         } else {
-            maze[u].g = std::numeric_limits<double>::infinity();
+            g[u] = INF;
             updateVertex(u);
-            int dr[] = {-1, 1, 0, 0};
-            int dc[] = {0, 0, -1, 1};
-            for (int i = 0; i < 4; ++i) {
-                Position predecessor = {u.row + dr[i], u.col + dc[i]};
-                 if (dynamic_grid.isWalkable(predecessor.row, predecessor.col)) {
-                    updateVertex(predecessor);
-                }
+        }
+        for (int offset : offsets) {
+            int predecessor = u + offset;
+            if (dynamic_grid.isWalkableAt(predecessor)) {
+                updateVertex(predecessor);
             }
         }
     }
@@ -113,49 +101,45 @@ void DStarLiteSolver::computeShortestPath() {
 
 
 void DStarLiteSolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     total_cost = {0, 0, 0};
     history.clear();
 
     initialize();
-    if (goal_pos.row == -1) {
-        history.push_back({0, dynamic_grid, start_pos, "FAILURE: No exit found.", total_cost, EvacuationMode::NORMAL});
+    if (grid.getExitPositions().empty()) {
+        history.record(0, dynamic_grid, start_pos, "FAILURE: No exit found.", total_cost, EvacuationMode::NORMAL);
         total_cost = {};
         return;
     }
     computeShortestPath();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
 
     for (int t = 0; t < 2 * (grid.getRows() * grid.getCols()); ++t) {
-        history.push_back({t, dynamic_grid, start_pos, "...", total_cost, EvacuationMode::NORMAL});
+        history.record(t, dynamic_grid, start_pos, "...", total_cost, EvacuationMode::NORMAL);
 
-        if (start_pos == goal_pos) {
+        const int start_idx = dynamic_grid.toIndex(start_pos);
+        if (dynamic_grid.isExitAt(start_idx)) {
             history.back().action = "SUCCESS: Reached Exit.";
             break;
         }
 
-        if (maze.find(start_pos) == maze.end() || maze[start_pos].g == std::numeric_limits<double>::infinity()) {
+        if (g[start_idx] == INF) {
             history.back().action = "FAILURE: No path found.";
             total_cost = {};
             break;
         }
 
-        Position next_move = start_pos;
-        double min_cost = std::numeric_limits<double>::infinity();
+        int next_move = start_idx;
+        double min_cost = INF;
         std::string action = "STAY";
 
-        int dr[] = {-1, 1, 0, 0};
-        int dc[] = {0, 0, -1, 1};
-        std::string actions[] = {"UP", "DOWN", "LEFT", "RIGHT"};
-        
+        const auto& offsets = dynamic_grid.getNeighborOffsets();
+        static const std::string actions[] = {"UP", "DOWN", "LEFT", "RIGHT"};
+
         for (int i = 0; i < 4; ++i) {
-            Position successor = {start_pos.row + dr[i], start_pos.col + dc[i]};
-            if (dynamic_grid.isWalkable(successor.row, successor.col)) {
-                if (maze.find(successor) == maze.end()) maze[successor] = DStarNode();
-                Cost move_cost = dynamic_grid.getMoveCost(successor);
-                double cost_val = (move_cost.smoke * 1000) + (move_cost.time * 10) + (move_cost.distance * 1);
-                double cost = maze[successor].g + cost_val;
+            int successor = start_idx + offsets[i];
+            if (dynamic_grid.isWalkableAt(successor)) {
+                double cost = g[successor] + stepCost(successor);
                 if (cost < min_cost) {
                     min_cost = cost;
                     next_move = successor;
@@ -166,28 +150,25 @@ void DStarLiteSolver::run() {
 
         history.back().action = action;
         total_cost = total_cost + dynamic_grid.getMoveCost(start_pos);
-        last_pos = start_pos;
-        start_pos = next_move;
-
-        bool cost_changed = false;
-        std::vector<Position> changed_cells;
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t + 1) {
-                Position changed_pos = {event_cfg.at("position").at("row"), event_cfg.at("position").at("col")};
-                dynamic_grid.addHazard(event_cfg);
-                changed_cells.push_back(changed_pos);
-                cost_changed = true;
-            }
+        start_pos = dynamic_grid.toPosition(next_move);
+
+        for (const auto& event : events.due(t + 1)) {
+            dynamic_grid.applyEvent(event);
         }
 
-        if (cost_changed) {
+        // Fire also raises the cost of the cells around it, so repair from the
+        // grid's change log rather than from the event cells alone.
+        const auto& changes = dynamic_grid.getChangedCells();
+        if (changes_seen < changes.size()) {
+            // last_pos is where the keys were last computed, not the last step.
             k_m += heuristic(last_pos, start_pos);
-            for (const auto& p : changed_cells) {
-                updateVertex(p);
-                 for (int i = 0; i < 4; ++i) {
-                    Position neighbor = {p.row + dr[i], p.col + dc[i]};
-                    if (dynamic_grid.isWalkable(neighbor.row, neighbor.col)) {
-                        updateVertex(neighbor);
+            last_pos = start_pos;
+            for (; changes_seen < changes.size(); ++changes_seen) {
+                int idx = changes[changes_seen];
+                updateVertex(idx);
+                for (int offset : offsets) {
+                    if (dynamic_grid.isWalkableAt(idx + offset)) {
+                        updateVertex(idx + offset);
                     }
                 }
             }
@@ -196,7 +177,7 @@ void DStarLiteSolver::run() {
     }
 
     if (history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)) {
-        history.push_back({(int)history.size(), dynamic_grid, start_pos, "FAILURE: Timed out.", total_cost, EvacuationMode::NORMAL});
+        history.record((int)history.size(), dynamic_grid, start_pos, "FAILURE: Timed out.", total_cost, EvacuationMode::NORMAL);
         total_cost = {};
     }
 }
@@ -208,11 +189,11 @@ Cost DStarLiteSolver::getEvacuationCost() const {
 
 void DStarLiteSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (D* Lite Solver)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         report_file << "<h3>Time Step: " << step.time_step << "</h3>\n";
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
\ No newline at end of file
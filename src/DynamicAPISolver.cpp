@@ -1,4 +1,5 @@
 #include "enmod/DynamicAPISolver.h"
+#include "enmod/EnvironmentAssessment.h"
 #include "enmod/API.h"
 #include "enmod/Logger.h"
 #include <algorithm>
@@ -7,63 +8,30 @@
 DynamicAPISolver::DynamicAPISolver(const Grid& grid_ref) 
     : Solver(grid_ref, "DynamicAPISim"), current_mode(EvacuationMode::NORMAL) {}
 
-void DynamicAPISolver::assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid) {
-    const auto& events = current_grid.getConfig().value("dynamic_events", json::array());
-    current_mode = EvacuationMode::NORMAL; 
-
-    for (const auto& event : events) {
-        if (event.value("type", "") == "fire") {
-            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
-            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
-                 int radius = 1;
-                if(event.value("size", "small") == "medium") radius = 2;
-                if(event.value("size", "small") == "large") radius = 3;
-                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
-                if (dist <= 1) { current_mode = EvacuationMode::PANIC; return; }
-                if (dist <= radius) { current_mode = EvacuationMode::ALERT; }
-            }
-        }
-    }
-
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
-    for(int i = 0; i < 4; ++i) {
-        Position neighbor = {current_pos.row + dr[i], current_pos.col + dc[i]};
-        if(current_grid.getSmokeIntensity(neighbor) == "heavy"){
-             if (current_mode != EvacuationMode::PANIC) current_mode = EvacuationMode::ALERT;
-        }
-    }
-}
-
 void DynamicAPISolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
         
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) {
-                // THE FIX: Pass the entire event configuration object
-                dynamic_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
 
-        assessThreatAndSetMode(current_pos, dynamic_grid);
-        Cost::current_mode = current_mode;
+        current_mode = assessThreatAndSetMode(current_pos, dynamic_grid);
         
-        history.push_back({t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode});
+        history.record(t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode);
 
         if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
             history.back().action = "SUCCESS: Reached Exit.";
             break;
         }
 
-        API step_planner(dynamic_grid);
+        API step_planner(dynamic_grid, current_mode);
         step_planner.run();
         const Policy& policy = step_planner.getPolicy();
         
@@ -87,11 +55,10 @@ void DynamicAPISolver::run() {
         current_pos = next_move;
     }
      if(history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)){
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
          total_cost = {};
      }
      
-     Cost::current_mode = EvacuationMode::NORMAL;
 }
 
 Cost DynamicAPISolver::getEvacuationCost() const {
@@ -100,7 +67,7 @@ Cost DynamicAPISolver::getEvacuationCost() const {
 
 void DynamicAPISolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (Turn-by-Turn using API Planner)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         std::string mode_str;
         switch(step.mode){
             case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
@@ -111,7 +78,7 @@ void DynamicAPISolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
 
@@ -1,134 +1,90 @@
 #include "enmod/DynamicAStarSolver.h"
+#include "enmod/EnvironmentAssessment.h"
 #include "enmod/Logger.h"
-#include <queue>
+#include "enmod/GridHeuristics.h"
+#include "enmod/RadixHeap.h"
+#include "enmod/SearchWorkspace.h"
 #include <vector>
-#include <map>
 #include <cmath>
 #include <algorithm>
 
-// A* Node for the priority queue
-struct AStarNode {
-    Position pos;
-    Cost cost;
-    double heuristic;
+// Helper function to run A* algorithm; Order ranks equal-f routes.
+template <typename Order>
+const std::vector<Position>& run_astar(const Grid& grid, const Position& start_pos, const GridHeuristics& heuristics, SearchWorkspace& workspace) {
+    // f = g.time + h never decreases during the search: h is the step distance
+    // to the nearest exit around walls and every step costs at least one time
+    // unit. That makes the open set a monotone queue, so a radix heap can
+    // replace the binary heap.
+    workspace.begin(grid);
+    RadixHeap<int>& open_set = workspace.radixQueue();
+    const auto& offsets = grid.getNeighborOffsets();
 
-    bool operator>(const AStarNode& other) const {
-        return (cost.time + heuristic) > (other.cost.time + other.heuristic);
-    }
-};
-
-// Helper function to run A* algorithm
-std::vector<Position> run_astar(const Grid& grid, const Position& start_pos) {
-    std::priority_queue<AStarNode, std::vector<AStarNode>, std::greater<AStarNode>> open_set;
-    std::map<Position, Position> came_from;
-    std::map<Position, Cost> g_score;
-
-    g_score[start_pos] = {0, 0, 0};
-
-    auto heuristic = [&](const Position& p) {
-        double h = std::numeric_limits<double>::max();
-        for (const auto& exit_pos : grid.getExitPositions()) {
-            h = std::min(h, (double)std::abs(p.row - exit_pos.row) + std::abs(p.col - exit_pos.col));
-        }
-        return h;
-    };
+    if (grid.getExitPositions().empty()) return workspace.emptyPath();
 
-    open_set.push({start_pos, {0, 0, 0}, heuristic(start_pos)});
+    int start_idx = grid.toIndex(start_pos);
+    if (heuristics.exitDistance(start_idx) == GridHeuristics::UNREACHABLE) return workspace.emptyPath();
+    workspace.reach(start_idx, {0, 0, 0}, -1);
+    open_set.push(heuristics.exitDistance(start_idx), start_idx);
 
     while (!open_set.empty()) {
-        Position current = open_set.top().pos;
-        open_set.pop();
-
-        if (grid.isExit(current.row, current.col)) {
-            std::vector<Position> path;
-            Position temp = current;
-            while (came_from.count(temp)) {
-                path.push_back(temp);
-                temp = came_from[temp];
-            }
-            path.push_back(start_pos);
-            std::reverse(path.begin(), path.end());
-            return path;
+        auto [f_score, current] = open_set.pop();
+        const Cost current_g = workspace.g(current);
+        // A later, faster route to this cell was already expanded from a smaller key.
+        if (f_score > static_cast<std::uint64_t>(current_g.time + heuristics.exitDistance(current))) {
+            continue;
         }
 
-        int dr[] = {-1, 1, 0, 0};
-        int dc[] = {0, 0, -1, 1};
-
-        for (int i = 0; i < 4; ++i) {
-            Position neighbor = {current.row + dr[i], current.col + dc[i]};
-
-            if (grid.isWalkable(neighbor.row, neighbor.col)) {
-                Cost tentative_g_score = g_score[current] + grid.getMoveCost(neighbor);
+        if (grid.isExitAt(current)) {
+            return workspace.tracePath(grid, current);
+        }
 
-                if (!g_score.count(neighbor) || tentative_g_score < g_score[neighbor]) {
-                    came_from[neighbor] = current;
-                    g_score[neighbor] = tentative_g_score;
-                    open_set.push({neighbor, tentative_g_score, heuristic(neighbor)});
+        for (int offset : offsets) {
+            int neighbor = current + offset;
+            // Cells that cannot reach an exit are never worth queueing.
+            if (grid.isWalkableAt(neighbor) && heuristics.exitDistance(neighbor) != GridHeuristics::UNREACHABLE) {
+                Cost tentative_g_score = current_g + grid.getMoveCostAt(neighbor);
+                if (!workspace.reached(neighbor) || Order::less(tentative_g_score, workspace.g(neighbor))) {
+                    workspace.reach(neighbor, tentative_g_score, current);
+                    open_set.push(tentative_g_score.time + heuristics.exitDistance(neighbor), neighbor);
                 }
             }
         }
     }
-    return {};
+    return workspace.emptyPath();
 }
 
 DynamicAStarSolver::DynamicAStarSolver(const Grid& grid_ref)
     : Solver(grid_ref, "DynamicAStarSim"), current_mode(EvacuationMode::NORMAL) {}
 
-void DynamicAStarSolver::assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid) {
-    const auto& events = current_grid.getConfig().value("dynamic_events", json::array());
-    current_mode = EvacuationMode::NORMAL;
-
-    for (const auto& event : events) {
-        if (event.value("type", "") == "fire") {
-            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
-            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
-                 int radius = 1;
-                if(event.value("size", "small") == "medium") radius = 2;
-                if(event.value("size", "small") == "large") radius = 3;
-                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
-                if (dist <= 1) { current_mode = EvacuationMode::PANIC; return; }
-                if (dist <= radius) { current_mode = EvacuationMode::ALERT; }
-            }
-        }
-    }
-
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
-    for(int i = 0; i < 4; ++i) {
-        Position neighbor = {current_pos.row + dr[i], current_pos.col + dc[i]};
-        if(current_grid.getSmokeIntensity(neighbor) == "heavy"){
-             if (current_mode != EvacuationMode::PANIC) current_mode = EvacuationMode::ALERT;
-        }
-    }
-}
-
 void DynamicAStarSolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
+    // Rebuilt only when a block or a lost exit makes its distances loose.
+    GridHeuristics heuristics(dynamic_grid);
+    SearchWorkspace workspace;
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) {
-                dynamic_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
 
-        assessThreatAndSetMode(current_pos, dynamic_grid);
-        Cost::current_mode = current_mode;
+        current_mode = assessThreatAndSetMode(current_pos, dynamic_grid);
 
-        history.push_back({t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode});
+        history.record(t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode);
 
         if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
             history.back().action = "SUCCESS: Reached Exit.";
             break;
         }
 
-        auto path = run_astar(dynamic_grid, current_pos);
+        heuristics.update();
+        const auto& path = withCostOrder(current_mode, [&](auto order) -> const std::vector<Position>& {
+            return run_astar<decltype(order)>(dynamic_grid, current_pos, heuristics, workspace);
+        });
         Position next_move = current_pos;
         std::string action = "STAY";
 
@@ -152,11 +108,10 @@ void DynamicAStarSolver::run() {
     }
 
     if (history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)) {
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
          total_cost = {};
     }
 
-    Cost::current_mode = EvacuationMode::NORMAL;
 }
 
 Cost DynamicAStarSolver::getEvacuationCost() const {
@@ -165,7 +120,7 @@ Cost DynamicAStarSolver::getEvacuationCost() const {
 
 void DynamicAStarSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (Turn-by-Turn using A* Planner)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         std::string mode_str;
         switch(step.mode){
             case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
@@ -176,6 +131,6 @@ void DynamicAStarSolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
\ No newline at end of file
@@ -1,127 +1,40 @@
 #include "enmod/DynamicHPASolver.h"
+#include "enmod/EnvironmentAssessment.h"
 #include "enmod/Logger.h"
-#include <queue>
+#include "enmod/HPAGraph.h"
 #include <vector>
-#include <map>
-#include <cmath>
-#include <algorithm>
-
-// A* Node for the priority queue
-struct HPAStarNode {
-    Position pos;
-    Cost cost;
-    double heuristic;
-
-    bool operator>(const HPAStarNode& other) const {
-        return (cost.time + heuristic) > (other.cost.time + other.heuristic);
-    }
-};
-
-// Helper function to run A* algorithm for one step
-std::vector<Position> run_astar_for_hpa_dynamic(const Grid& grid, const Position& start_pos) {
-    std::priority_queue<HPAStarNode, std::vector<HPAStarNode>, std::greater<HPAStarNode>> open_set;
-    std::map<Position, Position> came_from;
-    std::map<Position, Cost> g_score;
-
-    g_score[start_pos] = {0, 0, 0};
-
-    auto heuristic = [&](const Position& p) {
-        double h = std::numeric_limits<double>::max();
-        for (const auto& exit_pos : grid.getExitPositions()) {
-            h = std::min(h, (double)std::abs(p.row - exit_pos.row) + std::abs(p.col - exit_pos.col));
-        }
-        return h;
-    };
-
-    open_set.push({start_pos, {0, 0, 0}, heuristic(start_pos)});
-
-    while (!open_set.empty()) {
-        Position current = open_set.top().pos;
-        open_set.pop();
-
-        if (grid.isExit(current.row, current.col)) {
-            std::vector<Position> path;
-            Position temp = current;
-            while (came_from.count(temp)) {
-                path.push_back(temp);
-                temp = came_from[temp];
-            }
-            path.push_back(start_pos);
-            std::reverse(path.begin(), path.end());
-            return path;
-        }
-
-        int dr[] = {-1, 1, 0, 0};
-        int dc[] = {0, 0, -1, 1};
-
-        for (int i = 0; i < 4; ++i) {
-            Position neighbor = {current.row + dr[i], current.col + dc[i]};
-            if (grid.isWalkable(neighbor.row, neighbor.col)) {
-                Cost tentative_g_score = g_score[current] + grid.getMoveCost(neighbor);
-                if (!g_score.count(neighbor) || tentative_g_score < g_score[neighbor]) {
-                    came_from[neighbor] = current;
-                    g_score[neighbor] = tentative_g_score;
-                    open_set.push({neighbor, tentative_g_score, heuristic(neighbor)});
-                }
-            }
-        }
-    }
-    return {}; // No path found
-}
-
 
 DynamicHPASolver::DynamicHPASolver(const Grid& grid_ref)
     : Solver(grid_ref, "DynamicHPAStar") {}
 
-void DynamicHPASolver::assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid) {
-    const auto& events = current_grid.getConfig().value("dynamic_events", json::array());
-    current_mode = EvacuationMode::NORMAL;
-
-    for (const auto& event : events) {
-        if (event.value("type", "") == "fire") {
-            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
-            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
-                 int radius = 1;
-                if(event.value("size", "small") == "medium") radius = 2;
-                if(event.value("size", "small") == "large") radius = 3;
-                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
-                if (dist <= 1) { current_mode = EvacuationMode::PANIC; return; }
-                if (dist <= radius) { current_mode = EvacuationMode::ALERT; }
-            }
-        }
-    }
-}
-
 void DynamicHPASolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
+    // Abstract graph built once; each tick only recomputes the clusters the
+    // new events touched.
+    HPAGraph hpa(dynamic_grid);
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) {
-                dynamic_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
 
-        assessThreatAndSetMode(current_pos, dynamic_grid);
-        Cost::current_mode = current_mode;
+        current_mode = assessThreatAndSetMode(current_pos, dynamic_grid);
 
-        history.push_back({t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode});
+        history.record(t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode);
 
         if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
             history.back().action = "SUCCESS: Reached Exit.";
             break;
         }
         
-        // REPLANNING STEP: Run A* at each time step to get the next move.
-        // NOTE: This is now functionally equivalent to DynamicAStar. A true HPA*
-        // would build an abstract graph and only replan parts of the path.
-        auto path = run_astar_for_hpa_dynamic(dynamic_grid, current_pos);
+        // REPLANNING STEP: search the abstract graph and refine only the first leg.
+        hpa.update();
+        const auto& path = hpa.findFirstLeg(current_pos, current_mode);
         Position next_move = current_pos;
         std::string action = "STAY";
 
@@ -145,11 +58,10 @@ void DynamicHPASolver::run() {
     }
 
     if (history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)) {
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
          total_cost = {};
     }
 
-    Cost::current_mode = EvacuationMode::NORMAL;
 }
 
 Cost DynamicHPASolver::getEvacuationCost() const {
@@ -158,7 +70,7 @@ Cost DynamicHPASolver::getEvacuationCost() const {
 
 void DynamicHPASolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (Dynamic HPA*)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         std::string mode_str;
         switch(step.mode){
             case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
@@ -169,6 +81,6 @@ void DynamicHPASolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
\ No newline at end of file
@@ -7,46 +7,37 @@ DynamicSARSASolver::DynamicSARSASolver(const Grid& grid_ref)
 }
 
 void DynamicSARSASolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
     
-    train(1000); // Initial offline training
-    Direction action = chooseAction(current_pos);
+    pretrain(1000); // Initial offline training
+    Direction action = chooseAction(dynamic_grid.toIndex(current_pos));
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    TabularMDP live_mdp(dynamic_grid);
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) {
-                dynamic_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
+        live_mdp.update();
         
-        history.push_back({t, dynamic_grid, current_pos, "...", total_cost, EvacuationMode::NORMAL});
+        history.record(t, dynamic_grid, current_pos, "...", total_cost, EvacuationMode::NORMAL);
 
         if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
             history.back().action = "SUCCESS: Reached Exit.";
             break;
         }
 
-        Position next_pos = dynamic_grid.getNextPosition(current_pos, action);
-        
-        double reward = -1;
-        if (!dynamic_grid.isWalkable(next_pos.row, next_pos.col)) {
-            reward = -100; next_pos = current_pos;
-        } else if (dynamic_grid.isExit(next_pos.row, next_pos.col)) {
-            reward = 1000;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::FIRE) {
-            reward = -200;
-        } else if (dynamic_grid.getCellType(next_pos) == CellType::SMOKE) {
-            reward = -20;
-        }
+        int current_idx = dynamic_grid.toIndex(current_pos);
+        int next_idx = live_mdp.next(current_idx, static_cast<int>(action));
+        double reward = live_mdp.reward(current_idx, static_cast<int>(action));
+        Position next_pos = dynamic_grid.toPosition(next_idx);
 
-        Direction next_action = chooseAction(next_pos);
-        update(current_pos, action, reward, next_pos, next_action);
+        Direction next_action = chooseAction(next_idx);
+        update(current_idx, action, reward, next_idx, next_action);
         
         std::string action_str = "STAY";
         if (action == Direction::UP) action_str = "UP";
@@ -61,19 +52,19 @@ void DynamicSARSASolver::run() {
     }
 
     if(history.empty() || (history.back().action.find("SUCCESS") == std::string::npos)){
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, EvacuationMode::NORMAL});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, EvacuationMode::NORMAL);
          total_cost = {};
      }
 }
 Cost DynamicSARSASolver::getEvacuationCost() const { return total_cost; }
 void DynamicSARSASolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (Turn-by-Turn with Online SARSA)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         report_file << "<h3>Time Step: " << step.time_step << "</h3>\n";
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
 
@@ -0,0 +1,60 @@
+#include "enmod/EventTimeline.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+TimedEvent TimedEvent::fromJson(const json& event_config) {
+    TimedEvent event;
+    event.time = event_config.value("time_step", -1);
+    event.pos = {event_config.at("position").at("row"), event_config.at("position").at("col")};
+    event.level = 0;
+
+    std::string type = event_config.value("type", "");
+    if (type == "fire") {
+        event.type = HazardType::FIRE;
+        std::string size = event_config.value("size", "small");
+        event.level = 1;
+        if (size == "medium") event.level = 2;
+        if (size == "large") event.level = 3;
+    } else if (type == "smoke") {
+        event.type = HazardType::SMOKE;
+        event.level = event_config.value("intensity", "light") == "heavy" ? 2 : 1;
+    } else if (type == "path_block") {
+        event.type = HazardType::PATH_BLOCK;
+    } else {
+        event.type = HazardType::UNKNOWN;
+    }
+    return event;
+}
+
+EventTimeline::EventTimeline(const json& config_events) {
+    try {
+        events.reserve(config_events.size());
+        for (const auto& event_cfg : config_events) {
+            TimedEvent event = TimedEvent::fromJson(event_cfg);
+            // Events with no time step or an unknown type never fire.
+            if (event.time < 0 || event.type == HazardType::UNKNOWN) continue;
+            events.push_back(event);
+        }
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Failed to parse dynamic events: " + std::string(e.what()));
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const TimedEvent& a, const TimedEvent& b) { return a.time < b.time; });
+}
+
+EventTimeline::Cursor::Cursor(const EventTimeline& timeline)
+    : first(timeline.events.data()),
+      last(timeline.events.data() + timeline.events.size()),
+      next(first) {}
+
+EventRange EventTimeline::Cursor::due(int t) {
+    auto before = [](const TimedEvent& e, int time) { return e.time < time; };
+    if (next != first && (next - 1)->time >= t) {
+        next = std::lower_bound(first, next, t, before);
+    }
+    while (next != last && next->time < t) ++next;
+    const TimedEvent* begin = next;
+    while (next != last && next->time == t) ++next;
+    return {begin, next};
+}
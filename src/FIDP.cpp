@@ -1,10 +1,10 @@
 #include "enmod/FIDP.h"
 #include "enmod/HtmlReportGenerator.h"
-#include <queue>
+#include "enmod/CostQueue.h"
 #include <vector>
 #include <algorithm> 
 
-FIDP::FIDP(const Grid& grid_ref) : Solver(grid_ref, "FIDP") {}
+FIDP::FIDP(const Grid& grid_ref, EvacuationMode mode) : Solver(grid_ref, "FIDP"), mode(mode) {}
 
 // Original run method for the static solver
 void FIDP::run() {
@@ -13,37 +13,42 @@ void FIDP::run() {
 
 // NEW overloaded run method that accepts a starting position
 void FIDP::run(const Position& start_pos) {
-    cost_map.assign(grid.getRows(), std::vector<Cost>(grid.getCols()));
-    parent_map.assign(grid.getRows(), std::vector<Position>(grid.getCols(), {-1, -1}));
+    withCostOrder(mode, [&](auto order) { search<decltype(order)>(start_pos); });
+}
+
+template <typename Order>
+void FIDP::search(const Position& start_pos) {
+    cost_map.assign(grid.getCellCount(), Cost{});
+    parent_map.assign(grid.getCellCount(), -1);
 
-    std::priority_queue<std::pair<Cost, Position>, std::vector<std::pair<Cost, Position>>, std::greater<std::pair<Cost, Position>>> pq;
+    // The ordering is fixed for the whole search, so the queue can use packed integer keys.
+    CostQueue<Order> pq(grid);
 
-    cost_map[start_pos.row][start_pos.col] = {0, 0, 0};
-    pq.push({{0, 0, 0}, start_pos});
-    parent_map[start_pos.row][start_pos.col] = start_pos;
+    int start_idx = grid.toIndex(start_pos);
+    cost_map[start_idx] = {0, 0, 0};
+    pq.push({0, 0, 0}, start_idx);
+    parent_map[start_idx] = start_idx;
 
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
+    const auto& offsets = grid.getNeighborOffsets();
 
     while (!pq.empty()) {
-        auto [current_cost, current_pos] = pq.top();
-        pq.pop();
+        auto [current_cost, current_idx] = pq.pop();
 
-        if (cost_map[current_pos.row][current_pos.col] < current_cost) {
+        if (Order::less(cost_map[current_idx], current_cost)) {
             continue;
         }
 
-        for (int i = 0; i < 4; ++i) {
-            Position next_pos = {current_pos.row + dr[i], current_pos.col + dc[i]};
+        for (int offset : offsets) {
+            int next_idx = current_idx + offset;
 
-            if (grid.isWalkable(next_pos.row, next_pos.col)) {
-                Cost move_cost = grid.getMoveCost(next_pos);
+            if (grid.isWalkableAt(next_idx)) {
+                Cost move_cost = grid.getMoveCostAt(next_idx);
                 Cost new_cost = current_cost + move_cost;
 
-                if (new_cost < cost_map[next_pos.row][next_pos.col]) {
-                    cost_map[next_pos.row][next_pos.col] = new_cost;
-                    pq.push({new_cost, next_pos});
-                    parent_map[next_pos.row][next_pos.col] = current_pos;
+                if (Order::less(new_cost, cost_map[next_idx])) {
+                    cost_map[next_idx] = new_cost;
+                    pq.push(new_cost, next_idx);
+                    parent_map[next_idx] = current_idx;
                 }
             }
         }
@@ -57,8 +62,8 @@ std::vector<Position> FIDP::getEvacuationPath(const Position& start_pos) const {
     Position best_exit = {-1, -1};
 
     for (const auto& exit_pos : grid.getExitPositions()) {
-        if (cost_map[exit_pos.row][exit_pos.col] < best_cost) {
-            best_cost = cost_map[exit_pos.row][exit_pos.col];
+        if (costLess(mode, cost_map[grid.toIndex(exit_pos)], best_cost)) {
+            best_cost = cost_map[grid.toIndex(exit_pos)];
             best_exit = exit_pos;
         }
     }
@@ -67,14 +72,15 @@ std::vector<Position> FIDP::getEvacuationPath(const Position& start_pos) const {
         return path; 
     }
 
-    Position current = best_exit;
-    while (!(current == start_pos) && current.row != -1) {
-        path.push_back(current);
-        if (parent_map[current.row][current.col] == current) {
+    int start_idx = grid.toIndex(start_pos);
+    int current = grid.toIndex(best_exit);
+    while (current != start_idx && current != -1) {
+        path.push_back(grid.toPosition(current));
+        if (parent_map[current] == current) {
             path.clear(); // Invalid path
             break;
         }
-        current = parent_map[current.row][current.col];
+        current = parent_map[current];
     }
     path.push_back(start_pos); // Add the start position
     
@@ -86,8 +92,8 @@ std::vector<Position> FIDP::getEvacuationPath(const Position& start_pos) const {
 Cost FIDP::getEvacuationCost() const {
     Cost best_cost;
     for (const auto& exit_pos : grid.getExitPositions()) {
-        if (cost_map[exit_pos.row][exit_pos.col] < best_cost) {
-            best_cost = cost_map[exit_pos.row][exit_pos.col];
+        if (costLess(mode, cost_map[grid.toIndex(exit_pos)], best_cost)) {
+            best_cost = cost_map[grid.toIndex(exit_pos)];
         }
     }
     return best_cost;
@@ -3,28 +3,61 @@
 #include <stdexcept>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
 
-Grid::Grid(const json& config) : grid_config(config) {
+namespace {
+// splitmix64 finaliser; spreads small inputs over all 64 bits.
+std::uint64_t mixHash(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+}
+
+Grid::Grid(const json& config) : grid_config(std::make_shared<const json>(config)) {
     try {
         grid_name = config.at("name");
         rows = config.at("rows");
         cols = config.at("cols");
-        grid_map.assign(rows, std::vector<CellType>(cols, CellType::EMPTY));
+        stride = cols + 2;
+        neighbor_offsets = {-stride, stride, -1, 1};
+        cells.assign((rows + 2) * stride, CellType::WALL);
+        hazards.assign(cells.size(), HAZARD_SMOKE_NONE);
+        threat_map = ThreatMap(rows, cols);
+        for (int r = 0; r < rows; ++r) {
+            std::fill_n(cells.begin() + toIndex(r, 0), cols, CellType::EMPTY);
+        }
         for (const auto& wall_pos : config.at("walls")) {
-            grid_map[wall_pos.at("row")][wall_pos.at("col")] = CellType::WALL;
+            cells[toIndex(wall_pos.at("row"), wall_pos.at("col"))] = CellType::WALL;
         }
         for (const auto& smoke_cfg : config.at("smoke")) {
-            Position p = {smoke_cfg.at("row"), smoke_cfg.at("col")};
-            grid_map[p.row][p.col] = CellType::SMOKE;
-            smoke_intensities[p] = smoke_cfg.value("intensity", "light");
+            int idx = toIndex(smoke_cfg.at("row"), smoke_cfg.at("col"));
+            cells[idx] = CellType::SMOKE;
+            setSmoke(idx, smoke_cfg.value("intensity", "light") == "heavy" ? HAZARD_SMOKE_HEAVY : HAZARD_SMOKE_LIGHT);
         }
         for (const auto& exit_p : config.at("exits")) {
             Position p = {exit_p.at("row"), exit_p.at("col")};
-            grid_map[p.row][p.col] = CellType::EXIT;
+            cells[toIndex(p)] = CellType::EXIT;
             exit_pos.push_back(p);
         }
         start_pos = {config.at("start").at("row"), config.at("start").at("col")};
-        grid_map[start_pos.row][start_pos.col] = CellType::START;
+        cells[toIndex(start_pos)] = CellType::START;
+        timeline = std::make_shared<const EventTimeline>(config.value("dynamic_events", json::array()));
+
+        // Padding keeps the default (unreachable) cost; interior cells start hazard-free.
+        move_costs.assign(cells.size(), Cost{});
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) refreshMoveCost(toIndex(r, c));
+        }
+
+        // Per-cell terms are XORed in, so setMoveCost() and setCellUnwalkable()
+        // can swap a cell's term in O(1).
+        state_hash = mixHash((static_cast<std::uint64_t>(rows) << 32) | static_cast<std::uint32_t>(cols));
+        for (const auto& p : exit_pos) state_hash ^= mixHash(~static_cast<std::uint64_t>(toIndex(p)));
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) state_hash ^= cellStateHash(toIndex(r, c));
+        }
     } catch (const json::exception& e) {
         throw std::runtime_error("Failed to parse grid config: " + std::string(e.what()));
     }
@@ -34,56 +67,145 @@ int Grid::getCols() const { return cols; }
 const std::string& Grid::getName() const { return grid_name; }
 Position Grid::getStartPosition() const { return start_pos; }
 const std::vector<Position>& Grid::getExitPositions() const { return exit_pos; }
-const json& Grid::getConfig() const { return grid_config; }
+const json& Grid::getConfig() const { return *grid_config; }
 bool Grid::isValid(int r, int c) const { return r >= 0 && r < rows && c >= 0 && c < cols; }
-bool Grid::isWalkable(int r, int c) const { if (!isValid(r, c)) return false; return grid_map[r][c] != CellType::WALL; }
-bool Grid::isExit(int r, int c) const { if (!isValid(r,c)) return false; return grid_map[r][c] == CellType::EXIT; }
-CellType Grid::getCellType(const Position& pos) const { if (!isValid(pos.row, pos.col)) return CellType::WALL; return grid_map[pos.row][pos.col]; }
-std::string Grid::getSmokeIntensity(const Position& pos) const { if (smoke_intensities.count(pos)) { return smoke_intensities.at(pos); } return ""; }
+bool Grid::isWalkable(int r, int c) const { if (!isValid(r, c)) return false; return isWalkableAt(toIndex(r, c)); }
+bool Grid::isExit(int r, int c) const { if (!isValid(r,c)) return false; return isExitAt(toIndex(r, c)); }
+CellType Grid::getCellType(const Position& pos) const { if (!isValid(pos.row, pos.col)) return CellType::WALL; return cells[toIndex(pos)]; }
+std::string Grid::getSmokeIntensity(const Position& pos) const {
+    if (!isValid(pos.row, pos.col)) return "";
+    switch (hazards[toIndex(pos)] & HAZARD_SMOKE_MASK) {
+        case HAZARD_SMOKE_LIGHT: return "light";
+        case HAZARD_SMOKE_HEAVY: return "heavy";
+        default: return "";
+    }
+}
+
+void Grid::setSmoke(int idx, std::uint8_t level) {
+    bool was_heavy = hasHeavySmokeAt(idx);
+    hazards[idx] = static_cast<std::uint8_t>((hazards[idx] & ~HAZARD_SMOKE_MASK) | level);
+    if (was_heavy != hasHeavySmokeAt(idx)) threat_map.setHeavySmoke(idx, !was_heavy);
+}
+
+EvacuationMode Grid::getThreatLevel(const Position& pos) const {
+    if (!isValid(pos.row, pos.col)) return EvacuationMode::NORMAL;
+    return getThreatLevelAt(toIndex(pos));
+}
+
+void Grid::rebuildFireThreats() {
+    // Only fires that are still burning raise the threat level.
+    threat_map.clearFires();
+    for (const auto& fire : active_fires) {
+        if (cells[toIndex(fire.pos)] == CellType::FIRE) threat_map.addFire(fire.pos, fire.radius);
+    }
+}
+
+std::uint64_t Grid::cellStateHash(int idx) const {
+    const Cost& cost = move_costs[idx];
+    std::uint64_t h = mixHash(static_cast<std::uint64_t>(idx) * 2 + (isWalkableAt(idx) ? 1 : 0));
+    h = mixHash(h ^ static_cast<std::uint32_t>(cost.smoke));
+    return mixHash(h ^ ((static_cast<std::uint64_t>(static_cast<std::uint32_t>(cost.time)) << 32) | static_cast<std::uint32_t>(cost.distance)));
+}
+
+void Grid::refreshMoveCost(int idx) {
+    if (hazards[idx] & HAZARD_FIRE_INFLUENCE) return; // Fire cost wins over smoke
+    if (cells[idx] == CellType::SMOKE) {
+        setMoveCost(idx, hasHeavySmokeAt(idx) ? Cost{25, 4, 1} : Cost{5, 2, 1});
+    } else {
+        setMoveCost(idx, {0, 1, 1});
+    }
+}
+
+void Grid::setMoveCost(int idx, const Cost& cost) {
+    Cost& current = move_costs[idx];
+    if (current == cost) return;
+    // Unset costs are only filled in by the constructor; that is not a change.
+    bool constructed = current.distance != MAX_COST;
+    if (constructed) {
+        changed_cells.push_back(idx);
+        state_hash ^= cellStateHash(idx);
+        path_cost_bound.smoke -= current.smoke;
+        path_cost_bound.time -= current.time;
+        path_cost_bound.distance -= current.distance;
+    }
+    current = cost;
+    if (constructed) state_hash ^= cellStateHash(idx);
+    path_cost_bound.smoke += cost.smoke;
+    path_cost_bound.time += cost.time;
+    path_cost_bound.distance += cost.distance;
+}
+
+void Grid::stampFire(const FireEvent& fire) {
+    static const Cost fire_costs[] = {{1000, 100, 1}, {50, 10, 1}, {25, 5, 1}, {10, 2, 1}};
+    int radius = std::min(fire.radius, 3);
+    for (int dr = -radius; dr <= radius; ++dr) {
+        int span = radius - std::abs(dr);
+        for (int dc = -span; dc <= span; ++dc) {
+            int r = fire.pos.row + dr, c = fire.pos.col + dc;
+            if (!isValid(r, c)) continue;
+            int idx = toIndex(r, c);
+            // Earlier fires keep precedence, matching the old first-match scan.
+            if (hazards[idx] & HAZARD_FIRE_INFLUENCE) continue;
+            hazards[idx] |= HAZARD_FIRE_INFLUENCE;
+            setMoveCost(idx, fire_costs[std::abs(dr) + std::abs(dc)]);
+        }
+    }
+}
 
 void Grid::addHazard(const json& event_config) {
-    Position pos = {event_config.at("position").at("row"), event_config.at("position").at("col")};
+    applyEvent(TimedEvent::fromJson(event_config));
+}
+
+void Grid::applyEvent(const TimedEvent& event) {
+    const Position& pos = event.pos;
     if (!isValid(pos.row, pos.col)) {
         return; // Ignore events outside the grid
     }
+    applied_events.push_back(event);
 
-    std::string type = event_config.value("type", "");
-
-    if (type == "fire") {
-        // --- NEW: Check if the cell is already FIRE, if so, maybe update radius? Or just skip? ---
-        // For now, let's just overwrite/ensure it's fire. Could add logic later
-        // to handle increasing fire size/intensity if it hits an existing fire cell.
-        if (grid_map[pos.row][pos.col] != CellType::WALL) { // Don't overwrite walls
-             grid_map[pos.row][pos.col] = CellType::FIRE;
-             smoke_intensities.erase(pos); // Fire removes smoke
-             std::string size = event_config.value("size", "small");
-             int radius = 1;
-             if(size == "medium") radius = 2;
-             if(size == "large") radius = 3;
-             // Consider managing active_fires better (e.g., updating existing fire radius)
-             active_fires.push_back({pos, size, radius});
+    int idx = toIndex(pos);
+
+    if (event.type == HazardType::FIRE) {
+        if (cells[idx] != CellType::WALL) { // Don't overwrite walls
+             // Logged even if the cost stays put: a burning exit stops being one.
+             if (cells[idx] != CellType::FIRE) changed_cells.push_back(idx);
+             cells[idx] = CellType::FIRE;
+             setSmoke(idx, HAZARD_SMOKE_NONE); // Fire removes smoke
+             static const char* sizes[] = {"small", "medium", "large"};
+             FireEvent fire = {pos, sizes[event.level - 1], event.level};
+             // Repeated fire events at one cell keep a single entry with the largest radius.
+             auto existing = std::find_if(active_fires.begin(), active_fires.end(),
+                                          [&](const FireEvent& f) { return f.pos == pos; });
+             if (existing == active_fires.end()) {
+                 active_fires.push_back(fire);
+             } else if (fire.radius > existing->radius) {
+                 *existing = fire;
+             }
+             stampFire(fire);
+             threat_map.addFire(pos, fire.radius);
         }
     }
-    else if (type == "path_block") {
-        if (grid_map[pos.row][pos.col] != CellType::START && grid_map[pos.row][pos.col] != CellType::EXIT) {
+    else if (event.type == HazardType::PATH_BLOCK) {
+        if (cells[idx] != CellType::START && cells[idx] != CellType::EXIT) {
              setCellUnwalkable(pos); // Make the cell a wall (if not start/exit)
-             smoke_intensities.erase(pos); // Blockage removes smoke
-             // Potentially remove from active_fires if one exists there?
+             setSmoke(idx, HAZARD_SMOKE_NONE); // Blockage removes smoke
+             refreshMoveCost(idx);
         }
     }
-    // --- NEW: Handle dynamic smoke ---
-    else if (type == "smoke") {
+    else if (event.type == HazardType::SMOKE) {
         // Only add smoke to walkable, non-exit/start cells that aren't already on fire
-        if (grid_map[pos.row][pos.col] == CellType::EMPTY || grid_map[pos.row][pos.col] == CellType::SMOKE) {
-            grid_map[pos.row][pos.col] = CellType::SMOKE;
-            smoke_intensities[pos] = event_config.value("intensity", "light");
+        if (cells[idx] == CellType::EMPTY || cells[idx] == CellType::SMOKE) {
+            if (cells[idx] == CellType::EMPTY) changed_cells.push_back(idx);
+            cells[idx] = CellType::SMOKE;
+            setSmoke(idx, event.level == 2 ? HAZARD_SMOKE_HEAVY : HAZARD_SMOKE_LIGHT);
+            refreshMoveCost(idx);
         }
     }
     // --- NEW: Optional: Handle smoke clearing ---
-    // else if (type == "clear_smoke") {
-    //     if (grid_map[pos.row][pos.col] == CellType::SMOKE) {
-    //         grid_map[pos.row][pos.col] = CellType::EMPTY; // Change back to empty
-    //         smoke_intensities.erase(pos); // Remove intensity info
+    // else if (event.type == HazardType::CLEAR_SMOKE) {
+    //     if (cells[idx] == CellType::SMOKE) {
+    //         cells[idx] = CellType::EMPTY; // Change back to empty
+    //         setSmoke(idx, HAZARD_SMOKE_NONE); // Remove intensity info
     //     }
     // }
     // --- END NEW ---
@@ -91,20 +213,7 @@ void Grid::addHazard(const json& event_config) {
 
 Cost Grid::getMoveCost(const Position& pos) const {
     if (!isValid(pos.row, pos.col)) return {};
-    for(const auto& fire : active_fires){
-        int dist = std::abs(pos.row - fire.pos.row) + std::abs(pos.col - fire.pos.col);
-        if(dist <= fire.radius){
-            if(dist == 0) return {1000, 100, 1};
-            if(dist == 1) return {50, 10, 1};
-            if(dist == 2) return {25, 5, 1};
-            if(dist == 3) return {10, 2, 1};
-        }
-    }
-    if (grid_map[pos.row][pos.col] == CellType::SMOKE) {
-        if (smoke_intensities.count(pos) && smoke_intensities.at(pos) == "heavy") return {25, 4, 1};
-        return {5, 2, 1};
-    }
-    return {0, 1, 1};
+    return getMoveCostAt(toIndex(pos));
 }
 Position Grid::getNextPosition(const Position& current, Direction dir) const {
     switch (dir) {
@@ -117,7 +226,7 @@ Position Grid::getNextPosition(const Position& current, Direction dir) const {
 }
 std::string Grid::cellToHtml(int r, int c, const std::string& content) const {
     std::string class_name; std::string text = content;
-    switch (grid_map[r][c]) {
+    switch (cells[toIndex(r, c)]) {
         case CellType::WALL: class_name = "wall"; text = "W"; break;
         case CellType::START: class_name = "start"; text = "S"; break;
         case CellType::EXIT: class_name = "exit"; text = "E"; break;
@@ -139,15 +248,16 @@ std::string Grid::toHtmlString() const {
     ss << "</tbody></table>";
     return ss.str();
 }
-std::string Grid::toHtmlStringWithCost(const std::vector<std::vector<Cost>>& cost_map) const {
+std::string Grid::toHtmlStringWithCost(const std::vector<Cost>& cost_map) const {
     std::stringstream ss;
     ss << "<table class='grid-table'><tbody>";
     for(int r = 0; r < rows; ++r){
         ss << "<tr>";
         for(int c = 0; c < cols; ++c){
              std::stringstream content_ss;
-            if(cost_map[r][c].distance != MAX_COST) {
-                content_ss << "S:" << cost_map[r][c].smoke << "<br>T:" << cost_map[r][c].time << "<br>D:" << cost_map[r][c].distance;
+            const Cost& cost = cost_map[toIndex(r, c)];
+            if(cost.distance != MAX_COST) {
+                content_ss << "S:" << cost.smoke << "<br>T:" << cost.time << "<br>D:" << cost.distance;
             }
             ss << cellToHtml(r,c, content_ss.str());
         }
@@ -211,8 +321,15 @@ std::string Grid::toHtmlStringWithAgent(const Position& agent_pos) const {
 void Grid::setCellUnwalkable(const Position& pos) {
     if (isValid(pos.row, pos.col)) {
         // Ensure we don't block an exit
-        if (grid_map[pos.row][pos.col] != CellType::EXIT) {
-            grid_map[pos.row][pos.col] = CellType::WALL;
+        int idx = toIndex(pos);
+        if (cells[idx] != CellType::EXIT) {
+            bool was_fire = cells[idx] == CellType::FIRE;
+            state_hash ^= cellStateHash(idx);
+            cells[idx] = CellType::WALL;
+            state_hash ^= cellStateHash(idx);
+            changed_cells.push_back(idx);
+            refreshMoveCost(idx);
+            if (was_fire) rebuildFireThreats(); // A blocked fire no longer counts as burning
         }
     }
 }
@@ -0,0 +1,45 @@
+#include "enmod/GridHeuristics.h"
+
+GridHeuristics::GridHeuristics(const Grid& grid_ref) : grid(grid_ref) {
+    rebuild();
+}
+
+void GridHeuristics::update() {
+    const auto& changes = grid.getChangedCells();
+    bool stale = changes.size() < changes_seen;
+    for (size_t i = changes_seen; i < changes.size() && !stale; ++i) {
+        int idx = changes[i];
+        // Cost changes alone never matter: the field counts steps.
+        stale = (!grid.isWalkableAt(idx) && exit_distance[idx] != UNREACHABLE) ||
+                (exit_distance[idx] == 0 && !grid.isExitAt(idx));
+    }
+    changes_seen = changes.size();
+    if (stale) rebuild();
+}
+
+void GridHeuristics::rebuild() {
+    changes_seen = grid.getChangedCells().size();
+
+    exit_distance.assign(grid.getCellCount(), UNREACHABLE);
+    for (int idx = 0; idx < grid.getCellCount(); ++idx) {
+        if (grid.isExitAt(idx)) exit_distance[idx] = 0;
+    }
+
+    // BFS outwards from every exit at once.
+    std::vector<int>& dist = exit_distance;
+    const auto& offsets = grid.getNeighborOffsets();
+    frontier.clear();
+    for (int idx = 0; idx < grid.getCellCount(); ++idx) {
+        if (dist[idx] == 0) frontier.push_back(idx);
+    }
+    for (size_t head = 0; head < frontier.size(); ++head) {
+        int idx = frontier[head];
+        for (int offset : offsets) {
+            int next_idx = idx + offset;
+            if (grid.isWalkableAt(next_idx) && dist[next_idx] == UNREACHABLE) {
+                dist[next_idx] = dist[idx] + 1;
+                frontier.push_back(next_idx);
+            }
+        }
+    }
+}
@@ -0,0 +1,297 @@
+#include "enmod/HPAGraph.h"
+#include <algorithm>
+#include <type_traits>
+
+namespace {
+// Entrances at least this wide get a transition at each end instead of one in the middle.
+constexpr int WIDE_ENTRANCE = 6;
+
+template <typename Order>
+constexpr int orderSlot() { return std::is_same<Order, LexTimeFirst>::value ? 0 : 1; }
+}
+
+HPAGraph::HPAGraph(const Grid& grid_ref, int cluster_size)
+    : grid(grid_ref), cluster_size(cluster_size), heuristics(grid_ref) {
+    cluster_rows = (grid.getRows() + cluster_size - 1) / cluster_size;
+    cluster_cols = (grid.getCols() + cluster_size - 1) / cluster_size;
+    clusters.resize(cluster_rows * cluster_cols);
+    for (int cr = 0; cr < cluster_rows; ++cr) {
+        for (int cc = 0; cc < cluster_cols; ++cc) {
+            Cluster& cluster = clusters[cr * cluster_cols + cc];
+            cluster.row0 = cr * cluster_size;
+            cluster.col0 = cc * cluster_size;
+            cluster.rows = std::min(cluster_size, grid.getRows() - cluster.row0);
+            cluster.cols = std::min(cluster_size, grid.getCols() - cluster.col0);
+        }
+    }
+    border_down.resize(clusters.size());
+    border_right.resize(clusters.size());
+    for (int c = 0; c < getClusterCount(); ++c) {
+        buildBorder(c, true);
+        buildBorder(c, false);
+    }
+    node_slot.assign(grid.getCellCount(), -1);
+    for (int c = 0; c < getClusterCount(); ++c) buildNodes(c);
+    changes_seen = grid.getChangedCells().size();
+}
+
+int HPAGraph::clusterOfCell(int idx) const {
+    Position p = grid.toPosition(idx);
+    return clusterOf(p.row, p.col);
+}
+
+void HPAGraph::update() {
+    heuristics.update();
+    const auto& changes = grid.getChangedCells();
+    for (size_t i = changes_seen; i < changes.size(); ++i) {
+        Position p = grid.toPosition(changes[i]);
+        int c = clusterOf(p.row, p.col);
+        Cluster& cluster = clusters[c];
+        cluster.intra_valid = {false, false};
+        // Entrances only depend on walkability along the borders.
+        if (p.row == cluster.row0) invalidateBorder(c - cluster_cols, true);
+        if (p.row == cluster.row0 + cluster.rows - 1) invalidateBorder(c, true);
+        if (p.col == cluster.col0) invalidateBorder(c - 1, false);
+        if (p.col == cluster.col0 + cluster.cols - 1) invalidateBorder(c, false);
+    }
+    changes_seen = changes.size();
+}
+
+void HPAGraph::invalidateBorder(int cluster, bool horizontal) {
+    if (cluster < 0) return;
+    int cr = cluster / cluster_cols, cc = cluster % cluster_cols;
+    if (horizontal ? cr + 1 >= cluster_rows : cc + 1 >= cluster_cols) return;
+    int other = horizontal ? cluster + cluster_cols : cluster + 1;
+    buildBorder(cluster, horizontal);
+    clusters[cluster].nodes_valid = false;
+    clusters[other].nodes_valid = false;
+}
+
+// Scans the shared border of a cluster and its lower (horizontal) or right
+// neighbour for walkable runs and places transitions on them.
+void HPAGraph::buildBorder(int cluster, bool horizontal) {
+    auto& transitions = horizontal ? border_down[cluster] : border_right[cluster];
+    transitions.clear();
+    int cr = cluster / cluster_cols, cc = cluster % cluster_cols;
+    if (horizontal ? cr + 1 >= cluster_rows : cc + 1 >= cluster_cols) return;
+
+    const Cluster& c = clusters[cluster];
+    int length = horizontal ? c.cols : c.rows;
+    auto pairAt = [&](int i) {
+        int r = horizontal ? c.row0 + c.rows - 1 : c.row0 + i;
+        int col = horizontal ? c.col0 + i : c.col0 + c.cols - 1;
+        int inside = grid.toIndex(r, col);
+        int outside = horizontal ? inside + grid.getStride() : inside + 1;
+        return std::make_pair(inside, outside);
+    };
+    auto open = [&](int i) {
+        auto [inside, outside] = pairAt(i);
+        return grid.isWalkableAt(inside) && grid.isWalkableAt(outside);
+    };
+
+    for (int i = 0; i < length;) {
+        if (!open(i)) { ++i; continue; }
+        int run_start = i;
+        while (i < length && open(i)) ++i;
+        int run_end = i - 1;
+        if (run_end - run_start + 1 >= WIDE_ENTRANCE) {
+            transitions.push_back(pairAt(run_start));
+            transitions.push_back(pairAt(run_end));
+        } else {
+            transitions.push_back(pairAt((run_start + run_end) / 2));
+        }
+    }
+}
+
+void HPAGraph::buildNodes(int cluster) {
+    Cluster& c = clusters[cluster];
+    for (int idx : c.nodes) node_slot[idx] = -1;
+    c.nodes.clear();
+    c.links.clear();
+
+    auto addLink = [&](int node_cell, int other_cell) {
+        if (node_slot[node_cell] < 0) {
+            node_slot[node_cell] = static_cast<int>(c.nodes.size());
+            c.nodes.push_back(node_cell);
+        }
+        c.links.push_back({node_slot[node_cell], other_cell});
+    };
+    int cr = cluster / cluster_cols, cc = cluster % cluster_cols;
+    for (const auto& [inside, outside] : border_down[cluster]) addLink(inside, outside);
+    for (const auto& [inside, outside] : border_right[cluster]) addLink(inside, outside);
+    if (cr > 0) {
+        for (const auto& [inside, outside] : border_down[cluster - cluster_cols]) addLink(outside, inside);
+    }
+    if (cc > 0) {
+        for (const auto& [inside, outside] : border_right[cluster - 1]) addLink(outside, inside);
+    }
+    // Exits are nodes by position; whether one still counts is read live.
+    for (const auto& exit_pos : grid.getExitPositions()) {
+        int idx = grid.toIndex(exit_pos);
+        if (clusterOf(exit_pos.row, exit_pos.col) == cluster && node_slot[idx] < 0) {
+            node_slot[idx] = static_cast<int>(c.nodes.size());
+            c.nodes.push_back(idx);
+        }
+    }
+    c.nodes_valid = true;
+    c.intra_valid = {false, false};
+}
+
+const std::vector<Position>& HPAGraph::findFirstLeg(const Position& start, EvacuationMode mode) {
+    return withCostOrder(mode, [&](auto order) -> const std::vector<Position>& {
+        return search<decltype(order)>(start);
+    });
+}
+
+template <typename Order>
+void HPAGraph::clusterSearch(int cluster, int source_cell) {
+    const Cluster& c = clusters[cluster];
+    const auto& offsets = grid.getNeighborOffsets();
+    auto local = [&](int idx) {
+        Position p = grid.toPosition(idx);
+        return (p.row - c.row0) * c.cols + (p.col - c.col0);
+    };
+    auto inside = [&](int idx) {
+        Position p = grid.toPosition(idx);
+        return p.row >= c.row0 && p.row < c.row0 + c.rows && p.col >= c.col0 && p.col < c.col0 + c.cols;
+    };
+    // Min-heap on cost; equal costs pop in ascending cell index, as in CostQueue.
+    auto later = [](const std::pair<Cost, int>& a, const std::pair<Cost, int>& b) {
+        if (Order::less(b.first, a.first)) return true;
+        if (Order::less(a.first, b.first)) return false;
+        return a.second > b.second;
+    };
+
+    local_cost.assign(c.rows * c.cols, Cost{});
+    local_parent.assign(c.rows * c.cols, -1);
+    local_heap.clear();
+    local_cost[local(source_cell)] = {0, 0, 0};
+    local_heap.push_back({{0, 0, 0}, source_cell});
+
+    while (!local_heap.empty()) {
+        std::pop_heap(local_heap.begin(), local_heap.end(), later);
+        auto [cost, idx] = local_heap.back();
+        local_heap.pop_back();
+        if (Order::less(local_cost[local(idx)], cost)) continue;
+        for (int offset : offsets) {
+            int next = idx + offset;
+            if (!grid.isWalkableAt(next) || !inside(next)) continue;
+            Cost candidate = cost + grid.getMoveCostAt(next);
+            int slot = local(next);
+            if (Order::less(candidate, local_cost[slot])) {
+                local_cost[slot] = candidate;
+                local_parent[slot] = idx;
+                local_heap.push_back({candidate, next});
+                std::push_heap(local_heap.begin(), local_heap.end(), later);
+            }
+        }
+    }
+}
+
+template <typename Order>
+void HPAGraph::ensureIntra(int cluster) {
+    Cluster& c = clusters[cluster];
+    if (!c.nodes_valid) buildNodes(cluster);
+    constexpr int slot = orderSlot<Order>();
+    if (c.intra_valid[slot]) return;
+
+    int k = static_cast<int>(c.nodes.size());
+    std::vector<Cost>& matrix = c.intra[slot];
+    matrix.assign(k * k, Cost{});
+    for (int i = 0; i < k; ++i) {
+        clusterSearch<Order>(cluster, c.nodes[i]);
+        for (int j = 0; j < k; ++j) {
+            Position p = grid.toPosition(c.nodes[j]);
+            matrix[i * k + j] = local_cost[(p.row - c.row0) * c.cols + (p.col - c.col0)];
+        }
+    }
+    c.intra_valid[slot] = true;
+}
+
+const std::vector<Position>& HPAGraph::localPath(int cluster, int target_cell) {
+    const Cluster& c = clusters[cluster];
+    leg.clear();
+    for (int idx = target_cell; idx >= 0;) {
+        leg.push_back(grid.toPosition(idx));
+        Position p = leg.back();
+        idx = local_parent[(p.row - c.row0) * c.cols + (p.col - c.col0)];
+    }
+    std::reverse(leg.begin(), leg.end());
+    return leg;
+}
+
+template <typename Order>
+const std::vector<Position>& HPAGraph::search(const Position& start) {
+    // Abstract A* keyed like the flat A* family: f = g.time + exit step
+    // distance, which stays consistent over multi-step abstract edges.
+    workspace.begin(grid);
+    RadixHeap<int>& open_set = workspace.radixQueue();
+    leg.clear();
+    if (!grid.isValid(start.row, start.col)) return leg;
+
+    int start_idx = grid.toIndex(start);
+    int start_cluster = clusterOf(start.row, start.col);
+    ensureIntra<Order>(start_cluster);
+
+    // Connect the start to its cluster's nodes; -1 parents mark these first legs.
+    clusterSearch<Order>(start_cluster, start_idx);
+    const Cluster& home = clusters[start_cluster];
+    for (int node : home.nodes) {
+        Position p = grid.toPosition(node);
+        const Cost& cost = local_cost[(p.row - home.row0) * home.cols + (p.col - home.col0)];
+        int h = heuristics.exitDistance(node);
+        if (cost.distance == MAX_COST || h == GridHeuristics::UNREACHABLE) continue;
+        workspace.reach(node, cost, -1);
+        open_set.push(cost.time + h, node);
+    }
+
+    int goal = -1;
+    while (!open_set.empty()) {
+        auto [f_score, current] = open_set.pop();
+        const Cost current_g = workspace.g(current);
+        // A later, faster route to this node was already expanded from a smaller key.
+        if (f_score > static_cast<std::uint64_t>(current_g.time + heuristics.exitDistance(current))) continue;
+        if (grid.isExitAt(current)) {
+            goal = current;
+            break;
+        }
+
+        auto relax = [&](int next, const Cost& candidate) {
+            int h = heuristics.exitDistance(next);
+            if (candidate.distance == MAX_COST || h == GridHeuristics::UNREACHABLE) return;
+            if (!workspace.reached(next) || Order::less(candidate, workspace.g(next))) {
+                workspace.reach(next, candidate, current);
+                open_set.push(candidate.time + h, next);
+            }
+        };
+
+        int cluster = clusterOfCell(current);
+        ensureIntra<Order>(cluster);
+        const Cluster& c = clusters[cluster];
+        int from = node_slot[current];
+        if (from < 0) continue;
+        int k = static_cast<int>(c.nodes.size());
+        for (const auto& [slot, other] : c.links) {
+            if (slot == from && grid.isWalkableAt(other)) relax(other, current_g + grid.getMoveCostAt(other));
+        }
+        for (int j = 0; j < k; ++j) {
+            if (j != from) relax(c.nodes[j], current_g + c.intra[orderSlot<Order>()][from * k + j]);
+        }
+    }
+    if (goal < 0) return leg;
+
+    // Walk back to the first two nodes of the route.
+    int first = goal, second = -1;
+    while (workspace.parent(first) >= 0) {
+        second = first;
+        first = workspace.parent(first);
+    }
+    int target = (first != start_idx || second < 0) ? first : second;
+    if (clusterOfCell(target) != start_cluster) {
+        // The start is itself a transition and the route leaves through it.
+        leg = {start, grid.toPosition(target)};
+        return leg;
+    }
+    clusterSearch<Order>(start_cluster, start_idx);
+    return localPath(start_cluster, target);
+}
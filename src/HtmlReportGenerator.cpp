@@ -76,7 +76,7 @@ void HtmlReportGenerator::generateSummaryReport(const std::vector<Result>& resul
     std::vector<std::string> static_dp_solvers = {"BIDP", "FIDP", "API"};
     std::vector<std::string> static_heuristic_solvers = {"AStar"};
     std::vector<std::string> static_rl_solvers = {"QLearning", "SARSA", "ActorCritic"};
-    std::vector<std::string> dynamic_dp_solvers = {"DynamicBIDPSim", "DynamicFIDPSim", "DynamicAVISim", "DynamicAPISim"};
+    std::vector<std::string> dynamic_dp_solvers = {"DynamicBIDPSim", "DynamicFIDPSim", "DynamicAVISim", "DynamicAPISim", "TimeExpandedSim"};
     std::vector<std::string> dynamic_heuristic_solvers = {"DynamicAStarSim"}; 
     std::vector<std::string> dynamic_rl_solvers = {"DynamicQLearningSim", "DynamicSARSASim", "DynamicActorCriticSim"};
     std::vector<std::string> advanced_heuristic_solvers = {"DynamicHPAStar", "ADASolver", "DStarLiteSim"};
@@ -152,5 +152,51 @@ void HtmlReportGenerator::generateSummaryReport(const std::vector<Result>& resul
     write_solver_rows(hybrid_solvers);
 
     report_file << "</tbody></table>\n";
+
+    // Training effort of the learning solvers, in the order they ran.
+    std::vector<std::string> trained_solvers;
+    for (const auto& res : results) {
+        if (res.training && std::find(trained_solvers.begin(), trained_solvers.end(), res.solver_name) == trained_solvers.end()) {
+            trained_solvers.push_back(res.solver_name);
+        }
+    }
+    if (!trained_solvers.empty()) {
+        report_file << "<h2>RL Training</h2>\n<table>\n";
+        report_file << "<thead><tr><th rowspan='2'>Algorithm</th>";
+        for (const auto& scn : scenarios) {
+            report_file << "<th colspan='2'>" << scn << "</th>";
+        }
+        report_file << "</tr>\n<tr>";
+        for (size_t i = 0; i < scenarios.size(); ++i) {
+            report_file << "<th>Episodes</th><th>Time to Converge (ms)</th>";
+        }
+        report_file << "</tr></thead>\n<tbody>";
+        for (const auto& solver_name : trained_solvers) {
+            report_file << "<tr><td>" << solver_name << "</td>";
+            for (const auto& scn : scenarios) {
+                auto it = std::find_if(results.begin(), results.end(), [&](const Result& r){
+                    return r.scenario_name == scn && r.solver_name == solver_name;
+                });
+                if (it == results.end() || !it->training) {
+                    report_file << "<td colspan='2'>Not Run</td>";
+                    continue;
+                }
+                const TrainingStats& stats = *it->training;
+                report_file << "<td>" << stats.episodes << " / " << stats.episode_cap << "</td>";
+                report_file << "<td>";
+                if (stats.converged) {
+                    report_file << stats.time_ms;
+                } else if (!stats.early_stopping) {
+                    report_file << "Fixed budget (" << stats.time_ms << ")";
+                } else {
+                    report_file << "Not converged (" << stats.time_ms << ")";
+                }
+                if (stats.cached) report_file << "; cached, loaded in " << stats.load_ms;
+                report_file << "</td>";
+            }
+            report_file << "</tr>\n";
+        }
+        report_file << "</tbody></table>\n";
+    }
     writeHtmlFooter(report_file);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "enmod/HybridDPRLSolver.h"
+#include "enmod/EnvironmentAssessment.h"
 #include "enmod/Logger.h"
 #include <algorithm>
 #include <cmath>
@@ -6,60 +7,36 @@
 HybridDPRLSolver::HybridDPRLSolver(const Grid& grid_ref) 
     : Solver(grid_ref, "HybridDPRLSim"), current_mode(EvacuationMode::NORMAL) {
     
-    Cost::current_mode = EvacuationMode::NORMAL;
         // Pre-train the RL agent
     rl_solver = std::make_unique<QLearningSolver>(grid_ref);
-    rl_solver->train(5000); // Pre-train with 5000 episodes
+    rl_solver->pretrain(5000); // Pre-train with at most 5000 episodes
 }
 
-void HybridDPRLSolver::assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid) {
-    const auto& events = current_grid.getConfig().value("dynamic_events", json::array());
-    current_mode = EvacuationMode::NORMAL; 
-
-    for (const auto& event : events) {
-        if (event.value("type", "") == "fire") {
-            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
-            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
-                int radius = 1;
-                if(event.value("size", "small") == "medium") radius = 2;
-                if(event.value("size", "small") == "large") radius = 3;
-
-                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
-                if (dist <= 1) { current_mode = EvacuationMode::PANIC; return; }
-                if (dist <= radius) { current_mode = EvacuationMode::ALERT; }
-            }
-        }
-    }
-
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
-    for(int i = 0; i < 4; ++i) {
-        Position neighbor = {current_pos.row + dr[i], current_pos.col + dc[i]};
-        if(current_grid.getSmokeIntensity(neighbor) == "heavy"){
-             if (current_mode != EvacuationMode::PANIC) current_mode = EvacuationMode::ALERT;
-        }
-    }
+// Callers such as the multi-agent controller pass a fresh grid copy per call,
+// so each call plans on its own; CostFieldCache still shares equal states.
+Direction HybridDPRLSolver::getNextMove(const Position& current_pos, const Grid& current_grid) {
+    std::unique_ptr<IncrementalBIDP> call_planner;
+    return nextMove(current_pos, current_grid, call_planner);
 }
 
-
-Direction HybridDPRLSolver::getNextMove(const Position& current_pos, const Grid& current_grid) {
-    assessThreatAndSetMode(current_pos, current_grid);
-    Cost::current_mode = current_mode;
+Direction HybridDPRLSolver::nextMove(const Position& current_pos, const Grid& current_grid,
+                                     std::unique_ptr<IncrementalBIDP>& planner) {
+    current_mode = assessThreatAndSetMode(current_pos, current_grid);
 
     if (current_mode == EvacuationMode::PANIC) {
-        return rl_solver->chooseAction(current_pos);
+        return rl_solver->chooseAction(current_grid.toIndex(current_pos));
     } 
     else {
-        BIDP step_planner(current_grid);
-        step_planner.run();
-        const auto& cost_map = step_planner.getCostMap();
+        if (!planner) planner = std::make_unique<IncrementalBIDP>(current_grid);
+        planner->update(current_mode);
+        const auto& cost_map = planner->getCostMap();
         
         Cost best_neighbor_cost;
         Direction best_direction = Direction::STAY;
         
         // Check if a valid path exists from the current position
-        if (cost_map[current_pos.row][current_pos.col].distance != MAX_COST) {
-            best_neighbor_cost = cost_map[current_pos.row][current_pos.col];
+        if (cost_map[current_grid.toIndex(current_pos)].distance != MAX_COST) {
+            best_neighbor_cost = cost_map[current_grid.toIndex(current_pos)];
         }
 
         int dr[] = {-1, 1, 0, 0};
@@ -69,8 +46,8 @@ Direction HybridDPRLSolver::getNextMove(const Position& current_pos, const Grid&
         for (int i = 0; i < 4; ++i) {
             Position neighbor = {current_pos.row + dr[i], current_pos.col + dc[i]};
             if (current_grid.isWalkable(neighbor.row, neighbor.col)) {
-                if (cost_map[neighbor.row][neighbor.col] < best_neighbor_cost) {
-                    best_neighbor_cost = cost_map[neighbor.row][neighbor.col];
+                if (costLess(current_mode, cost_map[current_grid.toIndex(neighbor)], best_neighbor_cost)) {
+                    best_neighbor_cost = cost_map[current_grid.toIndex(neighbor)];
                     best_direction = dirs[i];
                 }
             }
@@ -80,24 +57,23 @@ Direction HybridDPRLSolver::getNextMove(const Position& current_pos, const Grid&
 }
 
 void HybridDPRLSolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
+    // Follows dynamic_grid through its events; gone when run() returns.
+    std::unique_ptr<IncrementalBIDP> planner = std::make_unique<IncrementalBIDP>(dynamic_grid);
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) {
-                dynamic_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
         
-        Direction move_dir = getNextMove(current_pos, dynamic_grid);
+        Direction move_dir = nextMove(current_pos, dynamic_grid, planner);
 
-        history.push_back({t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode});
+        history.record(t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode);
 
         if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
             history.back().action = "SUCCESS: Reached Exit.";
@@ -119,9 +95,8 @@ void HybridDPRLSolver::run() {
         else if (move_dir == Direction::RIGHT) action = "RIGHT";
 
         if (move_dir == Direction::STAY) {
-            BIDP check_planner(dynamic_grid);
-            check_planner.run();
-            if (check_planner.getEvacuationCost().distance == MAX_COST) {
+            planner->update(current_mode);
+            if (planner->getCost(dynamic_grid.getStartPosition()).distance == MAX_COST) {
                 history.back().action = "FAILURE: No path found.";
                 total_cost = {};
                 break;
@@ -134,11 +109,10 @@ void HybridDPRLSolver::run() {
     }
 
     if(history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)){
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
          total_cost = {};
     }
      
-    Cost::current_mode = EvacuationMode::NORMAL;
 }
 
 
@@ -146,7 +120,7 @@ Cost HybridDPRLSolver::getEvacuationCost() const { return total_cost; }
 
 void HybridDPRLSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (Hybrid DP-RL Solver)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         std::string mode_str;
         switch(step.mode){
             case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
@@ -157,6 +131,6 @@ void HybridDPRLSolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
\ No newline at end of file
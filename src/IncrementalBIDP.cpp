@@ -0,0 +1,137 @@
+#include "enmod/IncrementalBIDP.h"
+
+IncrementalBIDP::IncrementalBIDP(const Grid& grid_ref) : grid(grid_ref) {
+    flags.assign(grid.getCellCount(), 0);
+    for (const auto& exit_pos : grid.getExitPositions()) flags[grid.toIndex(exit_pos)] = FLAG_EXIT;
+}
+
+IncrementalBIDP::~IncrementalBIDP() { publish(); }
+
+void IncrementalBIDP::update(EvacuationMode mode) {
+    EvacuationMode order = costOrderMode(mode);
+    size_t change_count = grid.getChangedCells().size();
+    bool full_search = !field || order != solved_order || change_count < changes_seen;
+    if (!full_search && change_count == changes_seen) return;
+
+    CostFieldKey key{grid.getStateHash(), order};
+    if (CostFieldCache::Field cached = CostFieldCache::shared().find(key)) {
+        publish();
+        field = std::move(cached);
+    } else if (full_search) {
+        publish();
+        auto next = std::make_shared<std::vector<Cost>>(grid.getCellCount(), Cost{});
+        withCostOrder(order, [&](auto ordering) { solve<decltype(ordering)>(*next); });
+        field = next;
+        CostFieldCache::shared().insert(key, field);
+    } else {
+        if (!owned) {
+            owned = std::make_shared<std::vector<Cost>>(*field);
+            field = owned;
+        }
+        withCostOrder(order, [&](auto ordering) { repair<decltype(ordering)>(*owned, changes_seen); });
+        owned_key = key;
+    }
+    solved_order = order;
+    changes_seen = change_count;
+}
+
+void IncrementalBIDP::publish() {
+    if (!owned) return;
+    CostFieldCache::shared().insert(owned_key, std::move(owned));
+    owned.reset();
+}
+
+Cost IncrementalBIDP::getCost(const Position& pos) const {
+    if (!grid.isValid(pos.row, pos.col)) return {};
+    return (*field)[grid.toIndex(pos)];
+}
+
+template <typename Order>
+void IncrementalBIDP::solve(std::vector<Cost>& cost_map) {
+    CostQueue<Order> pq(grid);
+    for (const auto& exit_pos : grid.getExitPositions()) {
+        int exit_idx = grid.toIndex(exit_pos);
+        cost_map[exit_idx] = {0, 0, 0};
+        pq.push({0, 0, 0}, exit_idx);
+    }
+    propagate(cost_map, pq);
+}
+
+template <typename Order>
+void IncrementalBIDP::repair(std::vector<Cost>& cost_map, size_t first_change) {
+    const auto& changes = grid.getChangedCells();
+    const auto& offsets = grid.getNeighborOffsets();
+
+    // Exits stay at zero whatever happens to their own move cost.
+    affected.clear();
+    for (size_t i = first_change; i < changes.size(); ++i) {
+        int idx = changes[i];
+        if (!flags[idx]) {
+            flags[idx] = FLAG_AFFECTED;
+            affected.push_back(idx);
+        }
+    }
+
+    // A cell whose old cost is its move cost plus an affected neighbour's old
+    // cost may have been routed through it, so it is affected too. Everything
+    // left unmarked keeps a route that avoids the changed cells.
+    for (size_t i = 0; i < affected.size(); ++i) {
+        int idx = affected[i];
+        const Cost& old_cost = cost_map[idx];
+        if (old_cost.distance == MAX_COST) continue;
+        for (int offset : offsets) {
+            int prev_idx = idx + offset;
+            if (flags[prev_idx] || !grid.isWalkableAt(prev_idx)) continue;
+            if (cost_map[prev_idx] == old_cost + grid.getMoveCostAt(prev_idx)) {
+                flags[prev_idx] = FLAG_AFFECTED;
+                affected.push_back(prev_idx);
+            }
+        }
+    }
+
+    for (int idx : affected) cost_map[idx] = {};
+
+    // Re-seed the affected region from its neighbours. Changed cells that got
+    // cheaper are seeded too, so the search also lowers costs outside the region.
+    CostQueue<Order> pq(grid);
+    for (int idx : affected) {
+        flags[idx] = 0;
+        if (!grid.isWalkableAt(idx)) continue;
+        const Cost& move_cost = grid.getMoveCostAt(idx);
+        Cost best;
+        for (int offset : offsets) {
+            Cost candidate = cost_map[idx + offset] + move_cost;
+            if (Order::less(candidate, best)) best = candidate;
+        }
+        if (best.distance != MAX_COST) {
+            cost_map[idx] = best;
+            pq.push(best, idx);
+        }
+    }
+    propagate(cost_map, pq);
+}
+
+template <typename Order>
+void IncrementalBIDP::propagate(std::vector<Cost>& cost_map, CostQueue<Order>& pq) {
+    const auto& offsets = grid.getNeighborOffsets();
+
+    while (!pq.empty()) {
+        auto [current_cost, current_idx] = pq.pop();
+
+        if (Order::less(cost_map[current_idx], current_cost)) {
+            continue;
+        }
+
+        for (int offset : offsets) {
+            int next_idx = current_idx + offset;
+            // As in BIDP, a backward step costs the move out of the cell it reaches.
+            if (grid.isWalkableAt(next_idx)) {
+                Cost new_cost = current_cost + grid.getMoveCostAt(next_idx);
+                if (Order::less(new_cost, cost_map[next_idx])) {
+                    cost_map[next_idx] = new_cost;
+                    pq.push(new_cost, next_idx);
+                }
+            }
+        }
+    }
+}
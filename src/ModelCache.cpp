@@ -0,0 +1,162 @@
+#include "enmod/ModelCache.h"
+#include "enmod/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace {
+constexpr std::uint32_t MAGIC = 0x314d4d45; // "EMM1"
+// Bump whenever a learner's reward, update rule or table layout changes, so
+// models trained by older code are retrained instead of loaded.
+constexpr std::uint32_t FORMAT_VERSION = 1;
+
+enum SectionType : std::uint32_t { FLOAT32 = 1, UINT8 = 2 };
+
+struct FileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t key;
+    std::uint32_t section_count;
+    std::uint32_t reserved;
+};
+
+struct SectionHeader {
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t count;
+};
+
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+size_t padding(size_t bytes) { return (8 - bytes % 8) % 8; }
+
+void writeSection(std::ofstream& file, SectionType type, const void* data, size_t count, size_t element_size) {
+    SectionHeader header{type, 0, count};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(count * element_size));
+    static const char zeros[8] = {};
+    file.write(zeros, static_cast<std::streamsize>(padding(count * element_size)));
+}
+
+// Reads one section of the expected type and length. remaining is the byte
+// count left in the file, checked before allocating so a corrupt header can
+// never request more memory than the file could fill.
+template <typename T>
+bool readSection(std::ifstream& file, SectionType type, std::uint64_t count, std::uint64_t& remaining, std::vector<T>& out) {
+    SectionHeader header;
+    if (remaining < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    remaining -= sizeof(header);
+    if (header.type != type || header.count != count || count > remaining / sizeof(T)) return false;
+    const std::uint64_t bytes = count * sizeof(T);
+    const std::uint64_t padded = bytes + padding(static_cast<size_t>(bytes));
+    if (padded > remaining) return false;
+
+    out.resize(static_cast<size_t>(count));
+    char skip[8];
+    if (!file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(bytes)) ||
+        !file.read(skip, static_cast<std::streamsize>(padded - bytes))) {
+        return false;
+    }
+    remaining -= padded;
+    return true;
+}
+}
+
+ModelFingerprint::ModelFingerprint(const Grid& grid) : hash(grid.getStateHash()) {
+    Position start = grid.getStartPosition();
+    add(static_cast<std::uint64_t>(grid.toIndex(start)));
+}
+
+ModelFingerprint& ModelFingerprint::add(std::uint64_t value) {
+    hash = mix(hash ^ mix(value));
+    return *this;
+}
+
+ModelFingerprint& ModelFingerprint::add(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return add(bits);
+}
+
+ModelCache::ModelCache(std::string directory) : directory(std::move(directory)) {}
+
+ModelCache& ModelCache::shared() {
+    static ModelCache cache;
+    return cache;
+}
+
+std::string ModelCache::pathFor(const std::string& name, std::uint64_t key) const {
+    std::ostringstream path;
+    path << directory << "/" << name << "_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return path.str();
+}
+
+bool ModelCache::load(const std::string& name, std::uint64_t key, const ModelLayout& layout, ModelData& model) const {
+    if (!enabled) return false;
+    const std::string path = pathFor(name, key);
+    std::error_code error;
+    const std::uint64_t file_size = std::filesystem::file_size(path, error);
+    if (error) return false;
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    FileHeader header;
+    if (file_size < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (header.magic != MAGIC || header.version != FORMAT_VERSION || header.key != key) return false;
+    if (header.section_count != layout.floats.size() + layout.bytes.size()) return false;
+    std::uint64_t remaining = file_size - sizeof(header);
+
+    // Sections are written floats first, then bytes.
+    ModelData loaded;
+    loaded.floats.resize(layout.floats.size());
+    loaded.bytes.resize(layout.bytes.size());
+    for (size_t i = 0; i < layout.floats.size(); ++i) {
+        if (!readSection(file, FLOAT32, layout.floats[i], remaining, loaded.floats[i])) return false;
+    }
+    for (size_t i = 0; i < layout.bytes.size(); ++i) {
+        if (!readSection(file, UINT8, layout.bytes[i], remaining, loaded.bytes[i])) return false;
+    }
+    model = std::move(loaded);
+    return true;
+}
+
+void ModelCache::store(const std::string& name, std::uint64_t key, const ModelData& model) const {
+    if (!enabled) return;
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    const std::string path = pathFor(name, key);
+    // Unique per writer, so two runs storing the same model do not interleave.
+    const std::string temp_path = path + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            Logger::log(LogLevel::WARN, "Could not write model cache file " + temp_path);
+            return;
+        }
+        FileHeader header{MAGIC, FORMAT_VERSION, key, static_cast<std::uint32_t>(model.floats.size() + model.bytes.size()), 0};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& values : model.floats) writeSection(file, FLOAT32, values.data(), values.size(), sizeof(float));
+        for (const auto& values : model.bytes) writeSection(file, UINT8, values.data(), values.size(), 1);
+        if (!file) {
+            Logger::log(LogLevel::WARN, "Could not write model cache file " + temp_path);
+            file.close();
+            std::remove(temp_path.c_str());
+            return;
+        }
+    }
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::remove(temp_path.c_str());
+        Logger::log(LogLevel::WARN, "Could not publish model cache file " + path + ": " + error.message());
+    }
+}
@@ -65,13 +65,13 @@ Direction MultiAgentCPSController::read_output_file(int timestep, const Agent& a
 void MultiAgentCPSController::run_simulation() {
     std::cout << "\n===== Starting Real-Time Multi-Agent CPS Simulation for " << master_grid.getName() << " =====\n";
 
+    EventTimeline::Cursor events = master_grid.getEventTimeline().cursor();
+
     for (int t = 0; t < 2 * (master_grid.getRows() * master_grid.getCols()); ++t) {
         std::cout << "Timestep " << t << std::endl;
 
-        for (const auto& event_cfg : master_grid.getConfig().value("dynamic_events", json::array())) {
-            if (event_cfg.value("time_step", -1) == t) {
-                master_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            master_grid.applyEvent(event);
         }
 
         std::vector<Position> agent_positions;
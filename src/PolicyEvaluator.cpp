@@ -0,0 +1,75 @@
+#include "enmod/PolicyEvaluator.h"
+
+namespace {
+enum : std::uint8_t { UNVISITED, ON_CHAIN, DONE };
+}
+
+PolicyEvaluator::PolicyEvaluator(const Grid& grid_ref) : grid(grid_ref) {}
+
+const std::vector<Cost>& PolicyEvaluator::evaluate(const Policy& policy) {
+    values.assign(grid.getCellCount(), Cost{});
+    outcomes.assign(grid.getCellCount(), PolicyOutcome::DEAD_END);
+    state.assign(grid.getCellCount(), UNVISITED);
+    const auto& offsets = grid.getNeighborOffsets();
+
+    for (int r = 0; r < grid.getRows(); ++r) {
+        int idx = grid.toIndex(r, 0);
+        for (int c = 0; c < grid.getCols(); ++c, ++idx) {
+            if (state[idx] != UNVISITED || !grid.isWalkableAt(idx)) continue;
+
+            // Follow successors until the chain meets a known cell, an exit,
+            // a dead end, or itself.
+            chain.clear();
+            Cost tail;
+            PolicyOutcome outcome = PolicyOutcome::DEAD_END;
+            int current = idx;
+            while (true) {
+                if (state[current] == DONE) {
+                    tail = values[current];
+                    outcome = outcomes[current];
+                    break;
+                }
+                if (state[current] == ON_CHAIN) {
+                    outcome = PolicyOutcome::LOOPS;
+                    break;
+                }
+                if (grid.isExitAt(current)) {
+                    values[current] = {0, 0, 0};
+                    outcomes[current] = PolicyOutcome::REACHES_EXIT;
+                    state[current] = DONE;
+                    tail = values[current];
+                    outcome = PolicyOutcome::REACHES_EXIT;
+                    break;
+                }
+                state[current] = ON_CHAIN;
+                chain.push_back(current);
+
+                Direction dir = policy.getDirection(grid.toPosition(current));
+                if (dir == Direction::NONE) break;
+                int d = static_cast<int>(dir);
+                int next = (d < 4) ? current + offsets[d] : current; // STAY stays put
+                if (!grid.isWalkableAt(next)) break;
+                current = next;
+            }
+
+            // An unreachable tail stays unreachable: Cost addition saturates.
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                tail = grid.getMoveCostAt(*it) + tail;
+                values[*it] = tail;
+                outcomes[*it] = outcome;
+                state[*it] = DONE;
+            }
+        }
+    }
+    return values;
+}
+
+Cost PolicyEvaluator::getValue(const Position& pos) const {
+    if (!grid.isValid(pos.row, pos.col) || values.empty()) return {};
+    return values[grid.toIndex(pos)];
+}
+
+PolicyOutcome PolicyEvaluator::getOutcome(const Position& pos) const {
+    if (!grid.isValid(pos.row, pos.col) || outcomes.empty()) return PolicyOutcome::DEAD_END;
+    return outcomes[grid.toIndex(pos)];
+}
@@ -1,15 +1,15 @@
 #include "enmod/PolicyGenerator.h"
 #include "enmod/AVI.h"
+#include "enmod/PolicyEvaluator.h"
 #include <iomanip>
 #include <iostream>
-#include <set>
 #include <fstream>
 
-PolicyGenerator::PolicyGenerator(const Grid& grid_ref) 
-    : Solver(grid_ref, "PolicyGen"), policy(grid_ref.getRows(), grid_ref.getCols()) {}
+PolicyGenerator::PolicyGenerator(const Grid& grid_ref, EvacuationMode mode) 
+    : Solver(grid_ref, "PolicyGen"), mode(mode), policy(grid_ref.getRows(), grid_ref.getCols()) {}
 
 void PolicyGenerator::run() {
-    AVI avi_solver(grid);
+    AVI avi_solver(grid, mode);
     avi_solver.run();
     const auto& cost_map = avi_solver.getCostMap();
 
@@ -30,8 +30,8 @@ void PolicyGenerator::run() {
             for (int i = 0; i < 4; ++i) {
                 Position neighbor = {r + dr[i], c + dc[i]};
                 if (grid.isValid(neighbor.row, neighbor.col)) {
-                    if (cost_map[neighbor.row][neighbor.col] < best_neighbor_cost) {
-                        best_neighbor_cost = cost_map[neighbor.row][neighbor.col];
+                    if (costLess(mode, cost_map[grid.toIndex(neighbor)], best_neighbor_cost)) {
+                        best_neighbor_cost = cost_map[grid.toIndex(neighbor)];
                         best_direction = dirs[i];
                     }
                 }
@@ -39,7 +39,9 @@ void PolicyGenerator::run() {
             policy.setDirection({r, c}, best_direction);
         }
     }
-    final_cost = calculatePolicyCost();
+    PolicyEvaluator evaluator(grid);
+    evaluator.evaluate(policy);
+    final_cost = evaluator.getValue(grid.getStartPosition());
 }
 
 Cost PolicyGenerator::getEvacuationCost() const {
@@ -50,27 +52,6 @@ const Policy& PolicyGenerator::getPolicy() const {
     return policy;
 }
 
-Cost PolicyGenerator::calculatePolicyCost() const {
-    Position current = grid.getStartPosition();
-    Cost total_cost = {0, 0, 0};
-    std::set<Position> visited;
-
-    for (int i = 0; i < grid.getRows() * grid.getCols() + 1; ++i) {
-        if (grid.isExit(current.row, current.col)) {
-            return total_cost;
-        }
-        if (visited.count(current)) {
-            return {}; 
-        }
-        visited.insert(current);
-        
-        Direction dir = policy.getDirection(current);
-        total_cost = total_cost + grid.getMoveCost(current);
-        current = grid.getNextPosition(current, dir);
-    }
-    return {};
-}
-
 void PolicyGenerator::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Final Policy Map (Generated from AVI Cost Map)</h2>\n";
     report_file << grid.toHtmlStringWithPolicy(policy);
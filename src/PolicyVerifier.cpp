@@ -1,9 +1,9 @@
 #include "enmod/PolicyVerifier.h"
 #include "enmod/PolicyGenerator.h"
 #include "enmod/Logger.h"
+#include "enmod/PolicyEvaluator.h"
 #include <iostream>
 #include <vector>
-#include <set>
 
 PolicyVerifier::PolicyVerifier(const Grid& grid_ref) 
     : Solver(grid_ref, "PolicyVerify"), is_regular(false) {}
@@ -13,40 +13,21 @@ void PolicyVerifier::run() {
     temp_policy_gen.run();
     const Policy& optimal_policy = temp_policy_gen.getPolicy();
 
+    // One pass labels every cell; report the first failing one in row-major order.
+    PolicyEvaluator evaluator(grid);
+    evaluator.evaluate(optimal_policy);
     is_regular = true;
     for (int r = 0; r < grid.getRows(); ++r) {
         for (int c = 0; c < grid.getCols(); ++c) {
-            if (grid.isWalkable(r, c)) {
-                if (!isPathRegular({r, c}, optimal_policy)) {
-                    is_regular = false;
-                    Logger::log(LogLevel::ERROR, "Policy is IRREGULAR. Fails at starting point: (" + std::to_string(r) + "," + std::to_string(c) + ")");
-                    return; 
-                }
+            if (grid.isWalkable(r, c) && evaluator.getOutcome({r, c}) != PolicyOutcome::REACHES_EXIT) {
+                is_regular = false;
+                Logger::log(LogLevel::ERROR, "Policy is IRREGULAR. Fails at starting point: (" + std::to_string(r) + "," + std::to_string(c) + ")");
+                return;
             }
         }
     }
 }
 
-bool PolicyVerifier::isPathRegular(const Position& start_pos, const Policy& policy) const {
-    Position current = start_pos;
-    std::set<Position> visited;
-    for (int i = 0; i < grid.getRows() * grid.getCols() + 2; ++i) {
-        if (grid.isExit(current.row, current.col)) {
-            return true; 
-        }
-        if (visited.count(current)) {
-            return false; 
-        }
-        visited.insert(current);
-        Direction dir = policy.getDirection(current);
-        current = grid.getNextPosition(current, dir);
-        if (!grid.isWalkable(current.row, current.col)) {
-             return false; 
-        }
-    }
-    return false;
-}
-
 Cost PolicyVerifier::getEvacuationCost() const {
     return {};
 }
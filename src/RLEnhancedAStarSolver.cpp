@@ -1,146 +1,110 @@
 #include "enmod/RLEnhancedAStarSolver.h"
+#include "enmod/EnvironmentAssessment.h"
 #include "enmod/Logger.h"
-#include <queue>
+#include "enmod/GridHeuristics.h"
+#include "enmod/SearchWorkspace.h"
 #include <vector>
-#include <map>
 #include <cmath>
 #include <algorithm>
 
-// A* Node for the priority queue
-struct RLAStarNode {
-    Position pos;
-    Cost cost;
-    double heuristic;
-
-    bool operator>(const RLAStarNode& other) const {
-        // A* priority is f(n) = g(n) + h(n). Here, g(n) is represented by cost.time.
-        return (cost.time + heuristic) > (other.cost.time + other.heuristic);
-    }
-};
-
-// Helper function to run RL-enhanced A* algorithm
-std::vector<Position> run_rl_enhanced_astar(const Grid& grid, const Position& start_pos, QLearningSolver* rl_solver) {
-    std::priority_queue<RLAStarNode, std::vector<RLAStarNode>, std::greater<RLAStarNode>> open_set;
-    std::map<Position, Position> came_from;
-    std::map<Position, Cost> g_score;
+namespace {
+// Open-list order: smallest f(n) = g(n).time + h(n) first.
+bool rlLaterThan(const std::pair<double, int>& a, const std::pair<double, int>& b) {
+    return a.first > b.first;
+}
+}
 
-    g_score[start_pos] = {0, 0, 0};
+// Helper function to run RL-enhanced A* algorithm; Order ranks g-scores.
+template <typename Order>
+const std::vector<Position>& run_rl_enhanced_astar(const Grid& grid, const Position& start_pos, QLearningSolver* rl_solver,
+                                                   const GridHeuristics& heuristics, SearchWorkspace& workspace) {
+    workspace.begin(grid);
+    auto& open_set = workspace.heapQueue();
+    const auto& offsets = grid.getNeighborOffsets();
 
-    auto heuristic = [&](const Position& p) {
+    auto heuristic = [&](int idx) {
         // Use the trained Q-Learning model to get a heuristic.
         // A higher Q-value means a better state, so a lower heuristic cost.
         // We use the negative of the max Q-value for the state.
         const auto& value_table = rl_solver->getPolicyValueTable();
-        auto it = value_table.find(p);
 
-        if (it != value_table.end() && !it->second.empty()) {
-            double max_q_value = *std::max_element(it->second.begin(), it->second.end());
+        if (value_table.contains(idx)) {
+            double max_q_value = value_table.maxValue(idx);
             // Normalize or scale if necessary, for now, simple negation.
             return -max_q_value;
         }
 
-        // Fallback to Manhattan distance if the state is not in the Q-table
-        double h_manhattan = std::numeric_limits<double>::max();
-        for (const auto& exit_pos : grid.getExitPositions()) {
-            h_manhattan = std::min(h_manhattan, (double)std::abs(p.row - exit_pos.row) + std::abs(p.col - exit_pos.col));
-        }
-        return h_manhattan;
+        // Fall back to the step distance to the nearest exit if the state is not in the Q-table
+        int h_steps = heuristics.exitDistance(idx);
+        return h_steps == GridHeuristics::UNREACHABLE ? std::numeric_limits<double>::max() : static_cast<double>(h_steps);
     };
 
-    open_set.push({start_pos, {0, 0, 0}, heuristic(start_pos)});
+    int start_idx = grid.toIndex(start_pos);
+    workspace.reach(start_idx, {0, 0, 0}, -1);
+    open_set.push_back({heuristic(start_idx), start_idx});
 
     while (!open_set.empty()) {
-        Position current = open_set.top().pos;
-        open_set.pop();
-
-        if (grid.isExit(current.row, current.col)) {
-            std::vector<Position> path;
-            Position temp = current;
-            while (came_from.count(temp)) {
-                path.push_back(temp);
-                temp = came_from[temp];
-            }
-            path.push_back(start_pos);
-            std::reverse(path.begin(), path.end());
-            return path;
-        }
+        std::pop_heap(open_set.begin(), open_set.end(), rlLaterThan);
+        int current = open_set.back().second;
+        open_set.pop_back();
 
-        int dr[] = {-1, 1, 0, 0};
-        int dc[] = {0, 0, -1, 1};
+        if (grid.isExitAt(current)) {
+            return workspace.tracePath(grid, current);
+        }
 
-        for (int i = 0; i < 4; ++i) {
-            Position neighbor = {current.row + dr[i], current.col + dc[i]};
+        for (int offset : offsets) {
+            int neighbor = current + offset;
 
-            if (grid.isWalkable(neighbor.row, neighbor.col)) {
-                Cost tentative_g_score = g_score[current] + grid.getMoveCost(neighbor);
+            if (grid.isWalkableAt(neighbor)) {
+                Cost tentative_g_score = workspace.g(current) + grid.getMoveCostAt(neighbor);
 
-                if (!g_score.count(neighbor) || tentative_g_score < g_score[neighbor]) {
-                    came_from[neighbor] = current;
-                    g_score[neighbor] = tentative_g_score;
-                    open_set.push({neighbor, tentative_g_score, heuristic(neighbor)});
+                if (!workspace.reached(neighbor) || Order::less(tentative_g_score, workspace.g(neighbor))) {
+                    workspace.reach(neighbor, tentative_g_score, current);
+                    open_set.push_back({tentative_g_score.time + heuristic(neighbor), neighbor});
+                    std::push_heap(open_set.begin(), open_set.end(), rlLaterThan);
                 }
             }
         }
     }
-    return {}; // No path found
+    return workspace.emptyPath(); // No path found
 }
 
 
 RLEnhancedAStarSolver::RLEnhancedAStarSolver(const Grid& grid_ref)
     : Solver(grid_ref, "RLEnhancedAStar"), current_mode(EvacuationMode::NORMAL) {
-    Cost::current_mode = EvacuationMode::NORMAL;
     rl_solver = std::make_unique<QLearningSolver>(grid_ref);
     // Pre-train the RL agent on the initial grid to build the value table
-    rl_solver->train(2000); 
-}
-
-void RLEnhancedAStarSolver::assessThreatAndSetMode(const Position& current_pos, const Grid& current_grid) {
-    // This function is identical to other dynamic solvers
-    const auto& events = current_grid.getConfig().value("dynamic_events", json::array());
-    current_mode = EvacuationMode::NORMAL;
-
-    for (const auto& event : events) {
-        if (event.value("type", "") == "fire") {
-            Position fire_pos = {event.at("position").at("row"), event.at("position").at("col")};
-            if (current_grid.getCellType(fire_pos) == CellType::FIRE) {
-                 int radius = 1;
-                if(event.value("size", "small") == "medium") radius = 2;
-                if(event.value("size", "small") == "large") radius = 3;
-                int dist = std::abs(current_pos.row - fire_pos.row) + std::abs(current_pos.col - fire_pos.col);
-                if (dist <= 1) { current_mode = EvacuationMode::PANIC; return; }
-                if (dist <= radius) { current_mode = EvacuationMode::ALERT; }
-            }
-        }
-    }
+    rl_solver->pretrain(2000);
 }
 
 void RLEnhancedAStarSolver::run() {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid dynamic_grid = grid;
     Position current_pos = dynamic_grid.getStartPosition();
     total_cost = {0, 0, 0};
     history.clear();
 
-    const auto& events = dynamic_grid.getConfig().value("dynamic_events", json::array());
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
+    GridHeuristics heuristics(dynamic_grid);
+    SearchWorkspace workspace;
 
     for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
-        for (const auto& event_cfg : events) {
-            if (event_cfg.value("time_step", -1) == t) {
-                dynamic_grid.addHazard(event_cfg);
-            }
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
         }
 
-        assessThreatAndSetMode(current_pos, dynamic_grid);
-        Cost::current_mode = current_mode;
+        current_mode = assessThreatAndSetMode(current_pos, dynamic_grid);
 
-        history.push_back({t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode});
+        history.record(t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode);
 
         if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
             history.back().action = "SUCCESS: Reached Exit.";
             break;
         }
 
-        auto path = run_rl_enhanced_astar(dynamic_grid, current_pos, rl_solver.get());
+        heuristics.update();
+        const auto& path = withCostOrder(current_mode, [&](auto order) -> const std::vector<Position>& {
+            return run_rl_enhanced_astar<decltype(order)>(dynamic_grid, current_pos, rl_solver.get(), heuristics, workspace);
+        });
         Position next_move = current_pos;
         std::string action = "STAY";
 
@@ -164,11 +128,10 @@ void RLEnhancedAStarSolver::run() {
     }
 
     if (history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)) {
-         history.push_back({(int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode});
+         history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
          total_cost = {};
     }
 
-    Cost::current_mode = EvacuationMode::NORMAL;
 }
 
 Cost RLEnhancedAStarSolver::getEvacuationCost() const {
@@ -177,7 +140,7 @@ Cost RLEnhancedAStarSolver::getEvacuationCost() const {
 
 void RLEnhancedAStarSolver::generateReport(std::ofstream& report_file) const {
     report_file << "<h2>Simulation History (RL-Enhanced A* Solver)</h2>\n";
-    for (const auto& step : history) {
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
         std::string mode_str;
         switch(step.mode){
             case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
@@ -188,6 +151,6 @@ void RLEnhancedAStarSolver::generateReport(std::ofstream& report_file) const {
         report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
         report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
         report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
-        report_file << step.grid_state.toHtmlStringWithAgent(step.agent_pos);
-    }
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
 }
\ No newline at end of file
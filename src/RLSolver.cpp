@@ -1,11 +1,54 @@
 #include "enmod/RLSolver.h"
+#include "enmod/BIDP.h"
 #include "enmod/Logger.h"
+#include "enmod/PolicyEvaluator.h"
 #include <random>
 #include <chrono>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <utility>
 
-RLSolver::RLSolver(const Grid& grid_ref, const std::string& name)
-    : Solver(grid_ref, name), policy(grid_ref.getRows(), grid_ref.getCols()) {}
+namespace {
+// Fewer episodes than this per worker are not worth a thread.
+constexpr int MIN_EPISODES_PER_THREAD = 250;
+
+// TrainingStats as the last byte section of a cached model: episodes and
+// cap as int32, time_ms as a double, then the two flags.
+constexpr size_t STATS_BYTES = 4 + 4 + 8 + 1 + 1;
+
+std::vector<std::uint8_t> encodeStats(const TrainingStats& stats) {
+    std::vector<std::uint8_t> bytes(STATS_BYTES);
+    std::int32_t episodes = stats.episodes, cap = stats.episode_cap;
+    std::memcpy(&bytes[0], &episodes, 4);
+    std::memcpy(&bytes[4], &cap, 4);
+    std::memcpy(&bytes[8], &stats.time_ms, 8);
+    bytes[16] = stats.early_stopping ? 1 : 0;
+    bytes[17] = stats.converged ? 1 : 0;
+    return bytes;
+}
+
+TrainingStats decodeStats(const std::vector<std::uint8_t>& bytes) {
+    TrainingStats stats;
+    std::int32_t episodes, cap;
+    std::memcpy(&episodes, &bytes[0], 4);
+    std::memcpy(&cap, &bytes[4], 4);
+    std::memcpy(&stats.time_ms, &bytes[8], 8);
+    stats.episodes = episodes;
+    stats.episode_cap = cap;
+    stats.early_stopping = bytes[16] != 0;
+    stats.converged = bytes[17] != 0;
+    return stats;
+}
+}
+
+RLSolver::RLSolver(const Grid& grid_ref, const std::string& name, float initial_value)
+    : Solver(grid_ref, name), mdp(grid), initial_value(initial_value),
+      value_table(grid_ref.getCellCount(), initial_value),
+      policy(grid_ref.getRows(), grid_ref.getCols()),
+      rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count())) {}
 
 const Policy& RLSolver::getPolicy() {
     generatePolicyFromValueTable();
@@ -17,32 +60,232 @@ void RLSolver::run() {
     generatePolicyFromValueTable();
 }
 
+ConvergenceCriterion ConvergenceCriterion::valueDelta(double tolerance) {
+    ConvergenceCriterion criterion;
+    criterion.kind = Kind::VALUE_DELTA;
+    criterion.tolerance = tolerance;
+    return criterion;
+}
+
+ConvergenceCriterion ConvergenceCriterion::policyStable(int stable_windows) {
+    ConvergenceCriterion criterion;
+    criterion.kind = Kind::POLICY_STABLE;
+    criterion.stable_windows = stable_windows;
+    return criterion;
+}
+
+ConvergenceCriterion ConvergenceCriterion::referenceCost(const Cost& reference) {
+    ConvergenceCriterion criterion;
+    criterion.kind = Kind::REFERENCE_COST;
+    criterion.reference = reference;
+    return criterion;
+}
+
+void RLSolver::warmStart(const std::vector<Cost>& cost_map, const CostToReturn& mapping) {
+    std::vector<double> state_values(grid.getCellCount(), mapping.per_distance / (1 - gamma));
+    for (int r = 0; r < grid.getRows(); ++r) {
+        int idx = grid.toIndex(r, 0);
+        for (int c = 0; c < grid.getCols(); ++c, ++idx) {
+            const Cost& cost = cost_map[idx];
+            if (!grid.isWalkableAt(idx) || cost.distance == MAX_COST) continue;
+            if (grid.isExitAt(idx) || cost.distance == 0) {
+                state_values[idx] = 0; // Terminal.
+                continue;
+            }
+            const int steps = cost.distance;
+            double per_step = (mapping.per_smoke * cost.smoke + mapping.per_time * cost.time +
+                               mapping.per_distance * cost.distance) / steps;
+            double last_discount = std::pow(gamma, steps - 1);
+            state_values[idx] = per_step * (1 - last_discount) / (1 - gamma) + last_discount * mapping.exit_reward;
+        }
+    }
+    seedValues(state_values);
+}
+
+void RLSolver::seedValues(const std::vector<double>& state_values) {
+    for (int r = 0; r < grid.getRows(); ++r) {
+        int idx = grid.toIndex(r, 0);
+        for (int c = 0; c < grid.getCols(); ++c, ++idx) {
+            if (!grid.isWalkableAt(idx)) continue;
+            value_table.touch(idx);
+            for (int a = 0; a < ValueTable::ACTIONS; ++a) {
+                double value = mdp.reward(idx, a) + gamma * state_values[mdp.next(idx, a)];
+                value_table.set(idx, a, static_cast<float>(value));
+            }
+        }
+    }
+}
+
+void RLSolver::pretrain(int episodes) {
+    auto start_time = std::chrono::steady_clock::now();
+    ModelFingerprint fingerprint(grid);
+    fingerprint.add(alpha).add(gamma).add(epsilon).add(static_cast<double>(initial_value))
+        .add(static_cast<std::uint64_t>(episodes)).add(static_cast<std::uint64_t>(warm_start))
+        .add(cost_to_return.exit_reward).add(cost_to_return.per_smoke)
+        .add(cost_to_return.per_time).add(cost_to_return.per_distance);
+    const std::uint64_t key = fingerprint.value();
+
+    ModelLayout layout = modelLayout();
+    layout.bytes.push_back(STATS_BYTES);
+    ModelData model;
+    if (ModelCache::shared().load(solver_name, key, layout, model)) {
+        restoreModel(model);
+        training_stats = decodeStats(model.bytes.back());
+        training_stats.cached = true;
+        training_stats.load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        Logger::log(LogLevel::INFO, solver_name + " loaded its model from the cache");
+        return;
+    }
+
+    BIDP reference_solver(grid);
+    reference_solver.run();
+    if (warm_start) warmStart(reference_solver.getCostMap(), cost_to_return);
+    setConvergence(ConvergenceCriterion::referenceCost(reference_solver.getEvacuationCost()));
+    train(episodes);
+
+    model = {};
+    saveModel(model);
+    model.bytes.push_back(encodeStats(training_stats));
+    ModelCache::shared().store(solver_name, key, model);
+}
+
+ModelLayout RLSolver::modelLayout() const {
+    const std::uint64_t cells = static_cast<std::uint64_t>(value_table.cellCount());
+    return {{cells * ValueTable::ACTIONS}, {cells}};
+}
+
+void RLSolver::saveModel(ModelData& model) const {
+    const int cells = value_table.cellCount();
+    std::vector<float> values(static_cast<size_t>(cells) * ValueTable::ACTIONS);
+    std::vector<std::uint8_t> visited(cells);
+    for (int idx = 0; idx < cells; ++idx) {
+        visited[idx] = value_table.contains(idx) ? 1 : 0;
+        for (int a = 0; a < ValueTable::ACTIONS; ++a) {
+            values[static_cast<size_t>(idx) * ValueTable::ACTIONS + a] = value_table.get(idx, a);
+        }
+    }
+    model.floats.push_back(std::move(values));
+    model.bytes.push_back(std::move(visited));
+}
+
+void RLSolver::restoreModel(const ModelData& model) {
+    const int cells = value_table.cellCount();
+    for (int idx = 0; idx < cells; ++idx) {
+        if (model.bytes[0][idx]) value_table.touch(idx);
+        for (int a = 0; a < ValueTable::ACTIONS; ++a) {
+            value_table.set(idx, a, model.floats[0][static_cast<size_t>(idx) * ValueTable::ACTIONS + a]);
+        }
+    }
+}
+
 void RLSolver::train(int episodes) {
-     for (int i = 0; i < episodes; ++i) {
-        Position state = grid.getStartPosition();
-        Direction action = chooseAction(state);
-
-        for (int t = 0; t < grid.getRows() * grid.getCols(); ++t) {
-            Position next_state = grid.getNextPosition(state, action);
-            
-            double reward = -1;
-            if (!grid.isWalkable(next_state.row, next_state.col)) {
-                reward = -100; next_state = state;
-            } else if (grid.isExit(next_state.row, next_state.col)) {
-                reward = 1000;
-            } else if (grid.getCellType(next_state) == CellType::SMOKE) {
-                reward = -20;
-            } else if (grid.getCellType(next_state) == CellType::FIRE) {
-                reward = -200;
+    auto start_time = std::chrono::steady_clock::now();
+    training_stats = {0, episodes, 0, convergence.kind != ConvergenceCriterion::Kind::NONE, false};
+    window_values.clear();
+    window_actions.clear();
+    stable_count = 0;
+
+    if (convergence.kind == ConvergenceCriterion::Kind::NONE) {
+        runParallel(episodes);
+        training_stats.episodes = episodes;
+    } else {
+        const int window = std::max(1, convergence.check_interval);
+        // Also the baseline for the delta and stability criteria; only a
+        // warm-started learner can already match the reference.
+        training_stats.converged = hasConverged();
+        while (!training_stats.converged && training_stats.episodes < episodes) {
+            int share = std::min(window, episodes - training_stats.episodes);
+            runParallel(share);
+            training_stats.episodes += share;
+            training_stats.converged = hasConverged();
+        }
+    }
+
+    training_stats.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+    Logger::log(LogLevel::INFO, solver_name + " trained " + std::to_string(training_stats.episodes) + "/" +
+        std::to_string(episodes) + " episodes" + (training_stats.converged ? " (converged)" : ""));
+}
+
+bool RLSolver::hasConverged() {
+    switch (convergence.kind) {
+    case ConvergenceCriterion::Kind::VALUE_DELTA: {
+        const size_t entries = static_cast<size_t>(value_table.cellCount()) * ValueTable::ACTIONS;
+        bool first = window_values.empty();
+        double max_delta = 0;
+        window_values.resize(entries);
+        for (int idx = 0; idx < value_table.cellCount(); ++idx) {
+            for (int a = 0; a < ValueTable::ACTIONS; ++a) {
+                float value = value_table.get(idx, a);
+                float& previous = window_values[static_cast<size_t>(idx) * ValueTable::ACTIONS + a];
+                max_delta = std::max(max_delta, static_cast<double>(std::fabs(value - previous)));
+                previous = value;
             }
-            
-            Direction next_action = chooseAction(next_state);
+        }
+        return !first && max_delta <= convergence.tolerance;
+    }
+    case ConvergenceCriterion::Kind::POLICY_STABLE: {
+        bool first = window_actions.empty();
+        bool unchanged = true;
+        window_actions.resize(value_table.cellCount());
+        for (int idx = 0; idx < value_table.cellCount(); ++idx) {
+            int action = value_table.contains(idx) ? value_table.bestAction(idx) : -1;
+            if (action != window_actions[idx]) unchanged = false;
+            window_actions[idx] = action;
+        }
+        stable_count = (!first && unchanged) ? stable_count + 1 : 0;
+        return stable_count >= convergence.stable_windows;
+    }
+    case ConvergenceCriterion::Kind::REFERENCE_COST: {
+        generatePolicyFromValueTable();
+        PolicyEvaluator evaluator(grid);
+        evaluator.evaluate(policy);
+        Cost cost = evaluator.getValue(grid.getStartPosition());
+        return cost.distance != MAX_COST && !(convergence.reference < cost);
+    }
+    case ConvergenceCriterion::Kind::NONE:
+        break;
+    }
+    return false;
+}
+
+void RLSolver::runParallel(int episodes) {
+    int threads = training_threads > 0 ? training_threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, episodes / MIN_EPISODES_PER_THREAD));
+    if (threads == 1) {
+        runEpisodes(episodes, rng);
+        return;
+    }
+
+    // Seeds come from the solver's generator so each worker's stream differs.
+    std::vector<std::mt19937> worker_rngs;
+    for (int id = 0; id < threads; ++id) worker_rngs.emplace_back(rng());
+
+    std::vector<std::thread> workers;
+    for (int id = 0; id < threads; ++id) {
+        int share = episodes / threads + (id < episodes % threads ? 1 : 0);
+        workers.emplace_back([this, share, &worker_rngs, id] { runEpisodes(share, worker_rngs[id]); });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+void RLSolver::runEpisodes(int episodes, std::mt19937& episode_rng) {
+    const int start = grid.toIndex(grid.getStartPosition());
+    const int horizon = grid.getRows() * grid.getCols();
+    for (int i = 0; i < episodes; ++i) {
+        int state = start;
+        Direction action = sampleAction(state, episode_rng);
+
+        for (int t = 0; t < horizon; ++t) {
+            int next_state = mdp.next(state, static_cast<int>(action));
+            double reward = mdp.reward(state, static_cast<int>(action));
+
+            Direction next_action = sampleAction(next_state, episode_rng);
             update(state, action, reward, next_state, next_action);
 
             state = next_state;
             action = next_action;
 
-            if (grid.isExit(state.row, state.col)) {
+            if (mdp.isTerminal(state)) {
                 break;
             }
         }
@@ -51,18 +294,22 @@ void RLSolver::train(int episodes) {
 
 void RLSolver::generatePolicyFromValueTable() {
     for (int r = 0; r < grid.getRows(); ++r) {
-        for (int c = 0; c < grid.getCols(); ++c) {
+        int idx = grid.toIndex(r, 0);
+        for (int c = 0; c < grid.getCols(); ++c, ++idx) {
+            if (!grid.isWalkableAt(idx)) continue;
             Position pos = {r, c};
-            if (grid.isWalkable(r, c)) {
-                auto it = value_table.find(pos);
-                if (it != value_table.end()) {
-                    const auto& values = it->second;
-                    int best_action_idx = static_cast<int>(std::distance(values.begin(), std::max_element(values.begin(), values.end())));
-                    policy.setDirection(pos, static_cast<Direction>(best_action_idx));
-                } else {
-                    policy.setDirection(pos, Direction::NONE);
-                }
+            if (value_table.contains(idx)) {
+                policy.setDirection(pos, static_cast<Direction>(value_table.bestAction(idx)));
+            } else {
+                policy.setDirection(pos, Direction::NONE);
             }
         }
     }
-}
\ No newline at end of file
+}
+
+void RLSolver::writeTrainingSummary(std::ofstream& report_file) const {
+    report_file << "<p>This policy was learned over " << training_stats.episodes << " of at most "
+                << training_stats.episode_cap << " episodes in " << training_stats.time_ms << " ms"
+                << (training_stats.converged ? " (converged)" : training_stats.early_stopping ? " (not converged)" : "") << ".</p>\n";
+    if (training_stats.cached) report_file << "<p>It was loaded from the model cache in " << training_stats.load_ms << " ms.</p>\n";
+}
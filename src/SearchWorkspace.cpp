@@ -0,0 +1,27 @@
+#include "enmod/SearchWorkspace.h"
+#include <algorithm>
+
+void SearchWorkspace::begin(const Grid& grid) {
+    size_t cells = static_cast<size_t>(grid.getCellCount());
+    if (stamp.size() < cells) {
+        stamp.resize(cells, 0);
+        g_score.resize(cells);
+        came_from.resize(cells, -1);
+    }
+    if (++generation == 0) {
+        // The stamp wrapped; stale stamps could now look current.
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+    radix.clear();
+    heap.clear();
+}
+
+const std::vector<Position>& SearchWorkspace::tracePath(const Grid& grid, int idx) {
+    path.clear();
+    for (int current = idx; current >= 0; current = parent(current)) {
+        path.push_back(grid.toPosition(current));
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -0,0 +1,49 @@
+#include "enmod/TabularMDP.h"
+
+TabularMDP::TabularMDP(const Grid& grid_ref)
+    : grid(grid_ref), changes_seen(grid_ref.getChangedCells().size()) {
+    const size_t cells = static_cast<size_t>(grid.getCellCount());
+    next_state.assign(cells * ACTIONS, 0);
+    rewards.assign(cells * ACTIONS, 0.0f);
+    terminal.assign(cells, 0);
+    // The agent can stand on any interior cell, walls included once a hazard
+    // closes over it; the padded border is never a state.
+    for (int r = 0; r < grid.getRows(); ++r) {
+        int idx = grid.toIndex(r, 0);
+        for (int c = 0; c < grid.getCols(); ++c, ++idx) compile(idx);
+    }
+}
+
+void TabularMDP::compile(int idx) {
+    const auto& offsets = grid.getNeighborOffsets();
+    terminal[idx] = grid.isExitAt(idx) ? 1 : 0;
+    for (int a = 0; a < ACTIONS; ++a) {
+        int next = idx + offsets[a];
+        float reward = -1;
+        if (!grid.isWalkableAt(next)) {
+            reward = -100; next = idx;
+        } else if (grid.isExitAt(next)) {
+            reward = 1000;
+        } else if (grid.getCellTypeAt(next) == CellType::FIRE) {
+            reward = -200;
+        } else if (grid.getCellTypeAt(next) == CellType::SMOKE) {
+            reward = -20;
+        }
+        next_state[static_cast<size_t>(idx) * ACTIONS + a] = next;
+        rewards[static_cast<size_t>(idx) * ACTIONS + a] = reward;
+    }
+}
+
+// A changed cell alters its own terminal flag and every move into it.
+void TabularMDP::update() {
+    const auto& changes = grid.getChangedCells();
+    for (; changes_seen < changes.size(); ++changes_seen) {
+        int idx = changes[changes_seen];
+        compile(idx);
+        for (int offset : grid.getNeighborOffsets()) {
+            int neighbor = idx + offset;
+            Position pos = grid.toPosition(neighbor);
+            if (grid.isValid(pos.row, pos.col)) compile(neighbor);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include "enmod/ThreatMap.h"
+#include <algorithm>
+#include <cstdlib>
+
+ThreatMap::ThreatMap(int r, int c) : rows(r), cols(c), stride(c + 2) {
+    fire_mode.assign((rows + 2) * stride, static_cast<std::uint8_t>(EvacuationMode::NORMAL));
+    heavy_smoke_neighbors.assign(fire_mode.size(), 0);
+}
+
+void ThreatMap::addFire(const Position& pos, int radius) {
+    // A fire always panics its direct neighbours, even with a radius of 0.
+    int reach = std::max(radius, 1);
+    for (int dr = -reach; dr <= reach; ++dr) {
+        int span = reach - std::abs(dr);
+        for (int dc = -span; dc <= span; ++dc) {
+            int r = pos.row + dr, c = pos.col + dc;
+            if (r < 0 || r >= rows || c < 0 || c >= cols) continue;
+            int dist = std::abs(dr) + std::abs(dc);
+            EvacuationMode mode = dist <= 1 ? EvacuationMode::PANIC : EvacuationMode::ALERT;
+            std::uint8_t& cell = fire_mode[(r + 1) * stride + (c + 1)];
+            cell = std::max(cell, static_cast<std::uint8_t>(mode));
+        }
+    }
+}
+
+void ThreatMap::clearFires() {
+    std::fill(fire_mode.begin(), fire_mode.end(), static_cast<std::uint8_t>(EvacuationMode::NORMAL));
+}
+
+void ThreatMap::setHeavySmoke(int idx, bool heavy) {
+    for (int offset : {-stride, stride, -1, 1}) {
+        if (heavy) ++heavy_smoke_neighbors[idx + offset];
+        else --heavy_smoke_neighbors[idx + offset];
+    }
+}
@@ -0,0 +1,208 @@
+#include "enmod/TimeExpandedPlanner.h"
+#include "enmod/CostQueue.h"
+#include <algorithm>
+#include <cstdlib>
+
+TimeExpandedPlanner::TimeExpandedPlanner(const Grid& grid_ref, EvacuationMode mode)
+    : grid(grid_ref), mode(mode) {}
+
+void TimeExpandedPlanner::solve() {
+    const auto& events = grid.getEventTimeline().getEvents();
+    const int max_ticks = 2 * (grid.getRows() * grid.getCols());
+    horizon = events.empty() ? 0 : std::min(events.back().time, max_ticks - 1);
+
+    const int cell_count = grid.getCellCount();
+    CellState cells;
+    cells.flags.resize(cell_count);
+    cells.move_costs.resize(cell_count);
+    for (int idx = 0; idx < cell_count; ++idx) {
+        cells.flags[idx] = (grid.isWalkableAt(idx) ? CELL_WALKABLE : 0) | (grid.isExitAt(idx) ? CELL_EXIT : 0);
+        cells.move_costs[idx] = grid.getMoveCostAt(idx);
+    }
+
+    // State i holds from state_start[i]; undo[undo_begin[i], undo_begin[i + 1])
+    // turns it back into state i - 1. Events on tick 0 have nothing to undo.
+    std::vector<int> state_start{0};
+    std::vector<CellUndo> undo;
+    std::vector<size_t> undo_begin{0};
+    std::vector<int> undone_in(cell_count, -1);
+    Grid live = grid;
+    size_t i = 0;
+    while (i < events.size() && events[i].time <= horizon) {
+        int t = events[i].time;
+        const size_t first_change = live.getChangedCells().size();
+        for (; i < events.size() && events[i].time == t; ++i) live.applyEvent(events[i]);
+        const auto& changes = live.getChangedCells();
+        if (t > 0) {
+            state_start.push_back(t);
+            undo_begin.push_back(undo.size());
+            const int state = static_cast<int>(state_start.size()) - 1;
+            for (size_t c = first_change; c < changes.size(); ++c) {
+                int idx = changes[c];
+                if (undone_in[idx] == state) continue;
+                undone_in[idx] = state;
+                undo.push_back({idx, cells.flags[idx], cells.move_costs[idx]});
+            }
+        }
+        for (size_t c = first_change; c < changes.size(); ++c) {
+            int idx = changes[c];
+            cells.flags[idx] = (live.isWalkableAt(idx) ? CELL_WALKABLE : 0) | (live.isExitAt(idx) ? CELL_EXIT : 0);
+            cells.move_costs[idx] = live.getMoveCostAt(idx);
+        }
+    }
+    undo_begin.push_back(undo.size());
+
+    withCostOrder(mode, [&](auto order) { build<decltype(order)>(live, cells, state_start, undo, undo_begin); });
+}
+
+// cells starts as the final state and is walked back one event tick at a time.
+template <typename Order>
+void TimeExpandedPlanner::build(const Grid& final_state, CellState& cells, const std::vector<int>& state_start,
+                                const std::vector<CellUndo>& undo, const std::vector<size_t>& undo_begin) {
+    layers.clear();
+    layer_at.assign(horizon + 1, 0);
+
+    // From the horizon on the grid is static, so its shortest-path field is
+    // the value of every later tick.
+    std::vector<Cost> final_values;
+    staticField<Order>(final_state, final_values);
+    // A reach of rows + cols spans the whole grid.
+    step<Order>(cells, grid.getRows() + grid.getCols(), final_values, stationary);
+
+    size_t state = state_start.size() - 1;
+    Layer layer;
+    for (int t = horizon; t >= 0; --t) {
+        for (; state_start[state] > t; --state) {
+            for (size_t k = undo_begin[state]; k < undo_begin[state + 1]; ++k) {
+                cells.flags[undo[k].idx] = undo[k].flags;
+                cells.move_costs[undo[k].idx] = undo[k].move_cost;
+            }
+        }
+        step<Order>(cells, t, layers.empty() ? final_values : layers.back().values, layer);
+        if (layers.empty() || !sameWithin(layer, layers.back(), t)) {
+            layers.push_back(std::move(layer));
+            layer = Layer{};
+        } else {
+            // Each tick's layer is a function of the next one's within its
+            // reach, so with the grid unchanged back to the stretch's first
+            // tick every earlier layer agrees as well.
+            for (; t > state_start[state]; --t) layer_at[t] = static_cast<int>(layers.size()) - 1;
+        }
+        layer_at[t] = static_cast<int>(layers.size()) - 1;
+    }
+}
+
+// Backward Dijkstra from the cells that are exits in this state, with BIDP's
+// step cost (the move out of the cell being entered).
+template <typename Order>
+void TimeExpandedPlanner::staticField(const Grid& state, std::vector<Cost>& values) const {
+    const auto& offsets = state.getNeighborOffsets();
+    values.assign(state.getCellCount(), Cost{});
+    CostQueue<Order> pq(state);
+    for (int idx = 0; idx < state.getCellCount(); ++idx) {
+        if (state.isExitAt(idx)) {
+            values[idx] = {0, 0, 0};
+            pq.push({0, 0, 0}, idx);
+        }
+    }
+    while (!pq.empty()) {
+        auto [current_cost, current_idx] = pq.pop();
+        if (Order::less(values[current_idx], current_cost)) continue;
+        for (int offset : offsets) {
+            int next_idx = current_idx + offset;
+            if (!state.isWalkableAt(next_idx)) continue;
+            Cost new_cost = current_cost + state.getMoveCostAt(next_idx);
+            if (Order::less(new_cost, values[next_idx])) {
+                values[next_idx] = new_cost;
+                pq.push(new_cost, next_idx);
+            }
+        }
+    }
+}
+
+// One backward-induction step: the value of each cell on tick t is its move
+// cost on that tick plus the best value one tick later among itself (STAY) and
+// the neighbours walkable on that tick. Only cells within t steps of the start
+// can be occupied on tick t, so the rest of the layer stays unreachable.
+template <typename Order>
+void TimeExpandedPlanner::step(const CellState& cells, int t, const std::vector<Cost>& next_values, Layer& layer) const {
+    static const Direction dirs[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    const auto& offsets = grid.getNeighborOffsets();
+    const Position start = grid.getStartPosition();
+    const auto& flags = cells.flags;
+    layer.values.assign(grid.getCellCount(), Cost{});
+    layer.actions.assign(grid.getCellCount(), Direction::NONE);
+
+    const int row_begin = std::max(0, start.row - t);
+    const int row_end = std::min(grid.getRows() - 1, start.row + t);
+    for (int r = row_begin; r <= row_end; ++r) {
+        const int span = t - std::abs(r - start.row);
+        const int col_begin = std::max(0, start.col - span);
+        const int col_end = std::min(grid.getCols() - 1, start.col + span);
+        int idx = grid.toIndex(r, col_begin);
+        for (int c = col_begin; c <= col_end; ++c, ++idx) {
+            if (!(flags[idx] & CELL_WALKABLE)) continue;
+            if (flags[idx] & CELL_EXIT) {
+                layer.values[idx] = {0, 0, 0};
+                layer.actions[idx] = Direction::STAY;
+                continue;
+            }
+            const Cost& move_cost = cells.move_costs[idx];
+            Cost best;
+            Direction best_action = Direction::NONE;
+            // Moves come first, so a tie with waiting is broken towards moving.
+            for (int d = 0; d < 4; ++d) {
+                int next_idx = idx + offsets[d];
+                if (!(flags[next_idx] & CELL_WALKABLE)) continue;
+                Cost candidate = move_cost + next_values[next_idx];
+                if (Order::less(candidate, best)) {
+                    best = candidate;
+                    best_action = dirs[d];
+                }
+            }
+            Cost wait = move_cost + next_values[idx];
+            if (Order::less(wait, best)) {
+                best = wait;
+                best_action = Direction::STAY;
+            }
+            if (best.distance == MAX_COST) continue;
+            layer.values[idx] = best;
+            layer.actions[idx] = best_action;
+        }
+    }
+}
+
+bool TimeExpandedPlanner::sameWithin(const Layer& a, const Layer& b, int t) const {
+    const Position start = grid.getStartPosition();
+    const int row_begin = std::max(0, start.row - t);
+    const int row_end = std::min(grid.getRows() - 1, start.row + t);
+    for (int r = row_begin; r <= row_end; ++r) {
+        const int span = t - std::abs(r - start.row);
+        const int col_begin = std::max(0, start.col - span);
+        const int col_end = std::min(grid.getCols() - 1, start.col + span);
+        int idx = grid.toIndex(r, col_begin);
+        for (int c = col_begin; c <= col_end; ++c, ++idx) {
+            if (a.actions[idx] != b.actions[idx] || !(a.values[idx] == b.values[idx])) return false;
+        }
+    }
+    return true;
+}
+
+const TimeExpandedPlanner::Layer* TimeExpandedPlanner::layerAt(const Position& pos, int t) const {
+    if (layers.empty() || t < 0 || !grid.isValid(pos.row, pos.col)) return nullptr;
+    if (t > horizon) return &stationary;
+    // A shared layer may come from a later tick with a wider reach.
+    const Position start = grid.getStartPosition();
+    if (std::abs(pos.row - start.row) + std::abs(pos.col - start.col) > t) return nullptr;
+    return &layers[layer_at[t]];
+}
+
+Direction TimeExpandedPlanner::getAction(const Position& pos, int t) const {
+    const Layer* layer = layerAt(pos, t);
+    return layer ? layer->actions[grid.toIndex(pos)] : Direction::NONE;
+}
+
+Cost TimeExpandedPlanner::getCost(const Position& pos, int t) const {
+    const Layer* layer = layerAt(pos, t);
+    return layer ? layer->values[grid.toIndex(pos)] : Cost{};
+}
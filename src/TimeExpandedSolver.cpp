@@ -0,0 +1,67 @@
+#include "enmod/TimeExpandedSolver.h"
+#include "enmod/EnvironmentAssessment.h"
+#include <fstream>
+
+TimeExpandedSolver::TimeExpandedSolver(const Grid& grid_ref)
+    : Solver(grid_ref, "TimeExpandedSim"), planner(grid_ref), current_mode(EvacuationMode::NORMAL) {}
+
+void TimeExpandedSolver::run() {
+    Grid dynamic_grid = grid;
+    Position current_pos = dynamic_grid.getStartPosition();
+    total_cost = {0, 0, 0};
+    history.clear();
+
+    // The whole schedule is known, so a single solve covers every tick.
+    planner.solve();
+
+    EventTimeline::Cursor events = dynamic_grid.getEventTimeline().cursor();
+    static const char* actions[] = {"UP", "DOWN", "LEFT", "RIGHT", "STAY"};
+
+    for (int t = 0; t < 2 * (dynamic_grid.getRows() * dynamic_grid.getCols()); ++t) {
+        for (const auto& event : events.due(t)) {
+            dynamic_grid.applyEvent(event);
+        }
+        current_mode = assessThreatAndSetMode(current_pos, dynamic_grid);
+        history.record(t, dynamic_grid, current_pos, "Planning...", total_cost, current_mode);
+
+        if (dynamic_grid.isExit(current_pos.row, current_pos.col)) {
+            history.back().action = "SUCCESS: Reached Exit.";
+            break;
+        }
+
+        Direction action = planner.getAction(current_pos, t);
+        if (action == Direction::NONE) {
+            history.back().action = "FAILURE: No path found.";
+            total_cost = {};
+            break;
+        }
+
+        history.back().action = actions[static_cast<int>(action)];
+        total_cost = total_cost + dynamic_grid.getMoveCost(current_pos);
+        current_pos = dynamic_grid.getNextPosition(current_pos, action);
+    }
+    if (history.empty() || (history.back().action.find("SUCCESS") == std::string::npos && history.back().action.find("FAILURE") == std::string::npos)) {
+        history.record((int)history.size(), dynamic_grid, current_pos, "FAILURE: Timed out.", total_cost, current_mode);
+        total_cost = {};
+    }
+}
+
+Cost TimeExpandedSolver::getEvacuationCost() const { return total_cost; }
+
+void TimeExpandedSolver::generateReport(std::ofstream& report_file) const {
+    report_file << "<h2>Simulation History (Turn-by-Turn using Time-Expanded Plan)</h2>\n";
+    report_file << "<p><strong>Planning horizon:</strong> " << planner.getHorizon() << " ticks &nbsp; <strong>Stored layers:</strong> " << planner.getLayerCount() << "</p>\n";
+    history.replay([&](const StepReport& step, const Grid& grid_state) {
+        std::string mode_str;
+        switch(step.mode){
+            case EvacuationMode::NORMAL: mode_str = "NORMAL"; break;
+            case EvacuationMode::ALERT: mode_str = "ALERT"; break;
+            case EvacuationMode::PANIC: mode_str = "PANIC"; break;
+        }
+        report_file << "<h3>Time Step: " << step.time_step << " (Mode: " << mode_str << ")</h3>\n";
+        report_file << "<p><strong>Agent Position:</strong> (" << step.agent_pos.row << ", " << step.agent_pos.col << ")</p>\n";
+        report_file << "<p><strong>Action Taken:</strong> " << step.action << "</p>\n";
+        report_file << "<p><strong>Cumulative Cost:</strong> " << step.current_total_cost << "</p>\n";
+        report_file << grid_state.toHtmlStringWithAgent(step.agent_pos);
+    });
+}
@@ -0,0 +1,30 @@
+#include "enmod/TrajectoryRecorder.h"
+
+void TrajectoryRecorder::record(int time_step, const Grid& grid, const Position& agent_pos,
+                                const std::string& action, const Cost& total_cost, EvacuationMode mode) {
+    const auto& journal = grid.getAppliedEvents();
+    if (!base_grid) {
+        base_grid = std::make_unique<Grid>(grid);
+        base_journal_size = journal.size();
+    } else {
+        events.insert(events.end(), journal.begin() + base_journal_size + events.size(), journal.end());
+    }
+    steps.push_back({time_step, agent_pos, action, total_cost, mode, events.size()});
+}
+
+void TrajectoryRecorder::clear() {
+    base_grid.reset();
+    base_journal_size = 0;
+    events.clear();
+    steps.clear();
+}
+
+void TrajectoryRecorder::replay(const std::function<void(const StepReport&, const Grid&)>& visit) const {
+    if (!base_grid) return;
+    Grid grid_state = *base_grid;
+    size_t applied = 0;
+    for (const auto& step : steps) {
+        for (; applied < step.event_end; ++applied) grid_state.applyEvent(events[applied]);
+        visit(step, grid_state);
+    }
+}
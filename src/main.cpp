@@ -4,6 +4,8 @@
 #include "enmod/Solver.h"
 #include "enmod/HtmlReportGenerator.h"
 #include "enmod/Cost.h"
+#include "enmod/CostFieldCache.h"
+#include "enmod/ModelCache.h"
 // Static DP Solvers
 #include "enmod/BIDP.h"
 #include "enmod/FIDP.h"
@@ -13,6 +15,7 @@
 #include "enmod/DynamicAPISolver.h"
 #include "enmod/DynamicFIDPSolver.h"
 #include "enmod/DynamicAVISolver.h"
+#include "enmod/TimeExpandedSolver.h"
 // RL Solvers (Static and Dynamic headers)
 #include "enmod/QLearningSolver.h"
 #include "enmod/SARSASolver.h"
@@ -52,12 +55,13 @@
 #endif
 
 void runComparisonScenario(const json& config, const std::string& report_path, std::vector<Result>& results) {
-    Cost::current_mode = EvacuationMode::NORMAL;
     Grid grid(config);
     std::cout << "\n===== Running Comparison Scenario: " << grid.getName() << " (" << grid.getRows() << "x" << grid.getCols() << ") =====\n";
     std::string scenario_report_path = report_path + "/" + grid.getName();
     std::filesystem::create_directory(scenario_report_path);
     HtmlReportGenerator::generateInitialGridReport(grid, scenario_report_path);
+    // Fields from earlier scenarios can never match this grid's states.
+    CostFieldCache::shared().clear();
 
     std::vector<std::unique_ptr<Solver>> solvers;
 
@@ -75,6 +79,7 @@ void runComparisonScenario(const json& config, const std::string& report_path, s
     solvers.push_back(std::make_unique<DynamicFIDPSolver>(grid));
     solvers.push_back(std::make_unique<DynamicAVISolver>(grid));
     solvers.push_back(std::make_unique<DynamicAPISolver>(grid));
+    solvers.push_back(std::make_unique<TimeExpandedSolver>(grid));
     solvers.push_back(std::make_unique<DynamicAStarSolver>(grid));
     solvers.push_back(std::make_unique<DStarLiteSolver>(grid));
     solvers.push_back(std::make_unique<DynamicQLearningSolver>(grid));
@@ -103,13 +108,30 @@ void runComparisonScenario(const json& config, const std::string& report_path, s
 
         Cost final_cost = solver->getEvacuationCost();
         double weighted_cost = (final_cost.distance == MAX_COST) ? std::numeric_limits<double>::infinity() : (final_cost.smoke * 1000) + (final_cost.time * 10) + (final_cost.distance * 1);
-        results.push_back({grid.getName(), solver->getName(), final_cost, weighted_cost, execution_time.count()});
+        const TrainingStats* stats = solver->getTrainingStats();
+        results.push_back({grid.getName(), solver->getName(), final_cost, weighted_cost, execution_time.count(),
+                           stats ? std::optional<TrainingStats>(*stats) : std::nullopt});
         HtmlReportGenerator::generateSolverReport(*solver, scenario_report_path);
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        // Trained RL models are only cached on disk when asked for, so a
+        // comparison run never depends on what earlier runs left behind.
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--model-cache") {
+                ModelCache::shared().setEnabled(true);
+            } else if (arg.rfind("--model-cache=", 0) == 0) {
+                ModelCache::shared().setEnabled(true);
+                ModelCache::shared().setDirectory(arg.substr(std::string("--model-cache=").size()));
+            } else {
+                std::cerr << "Unknown option: " << arg << "\nUsage: " << argv[0] << " [--model-cache[=DIR]]\n";
+                return 1;
+            }
+        }
+
         std::filesystem::create_directory("logs");
         std::filesystem::create_directory("reports");
         Logger::init("logs/enmod_simulation.log");
@@ -121,6 +143,9 @@ int main() {
         std::filesystem::create_directory(report_root_path);
         std::cout << "Log file created at: logs/enmod_simulation.log\n";
         std::cout << "Reports will be generated in: " << report_root_path << "\n";
+        if (ModelCache::shared().isEnabled()) {
+            std::cout << "Caching trained RL models in: " << ModelCache::shared().getDirectory() << "\n";
+        }
 
         // --- PHASE 1: Run the comprehensive comparison of all solvers ---
         std::vector<json> scenarios;